@@ -0,0 +1,36 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_BENCH_H_
+#define LIBSE_BENCH_H_
+
+#include <cstdio>
+
+#include "libse.h"
+
+namespace se {
+
+/// Call instead of Slicer::begin_slice_loop() in a benchmark
+
+/// If SE_PRIORITIZE is defined, e.g. with `make CPPFLAGS=-DSE_PRIORITIZE`,
+/// the slices are checked in order of priority, see Slicer::set_prioritization().
+/// Otherwise, they are checked in the default order. Either way, the slicer
+/// is left as the benchmark has constructed it, so both orders slice the
+/// same branches.
+inline void begin_bench_slice_loop(Slicer& slicer) {
+#ifdef SE_PRIORITIZE
+  slicer.set_prioritization(true);
+#endif
+  slicer.begin_slice_loop();
+}
+
+/// Print how long and how many slices it took a benchmark to find a bug
+inline void report_first_bug(const Slicer& slicer) {
+  std::printf("time-to-first-bug %.6f s in slice %u\n",
+    slicer.elapsed_time().count() / 1e6, slicer.slice_count());
+}
+
+}
+
+#endif
@@ -1,7 +1,7 @@
 // Adapted from the SV-COMP'13 benchmark:
 //   https://svn.sosy-lab.org/software/sv-benchmarks/trunk/c/pthread/fib_bench_longer_unsafe.c
 
-#include "libse.h"
+#include "bench.h"
 
 using namespace se::ops;
 
@@ -25,7 +25,7 @@ void f1() {
 }
 
 int main(void) {
-  slicer.begin_slice_loop();
+  se::begin_bench_slice_loop(slicer);
   do {
     se::Thread::encoders().reset();
 
@@ -38,6 +38,7 @@ int main(void) {
     t1.join();
 
     if (se::Thread::encode() && smt::sat == se::Thread::encoders().solver.check()) {
+      se::report_first_bug(slicer);
       return 0;
     }
   } while (slicer.next_slice());
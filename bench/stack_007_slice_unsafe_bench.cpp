@@ -1,7 +1,7 @@
 // Adapted from the SV-COMP'13 benchmark:
 //   https://svn.sosy-lab.org/software/sv-benchmarks/trunk/c/pthread/stack_safe.c
 
-#include "libse.h"
+#include "bench.h"
 #include "concurrent/mutex.h"
 
 using namespace se::ops;
@@ -47,7 +47,7 @@ void f2() {
 }
 
 int main(void) {
-  slicer.begin_slice_loop();
+  se::begin_bench_slice_loop(slicer);
   do {
     se::Thread::encoders().reset();
 
@@ -55,6 +55,7 @@ int main(void) {
     se::Thread t2(f2);
 
     if (se::Thread::encode() && smt::sat == se::Thread::encoders().solver.check()) {
+      se::report_first_bug(slicer);
       return 0;
     }
   } while (slicer.next_slice());
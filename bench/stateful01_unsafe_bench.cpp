@@ -1,7 +1,7 @@
 // Adapted from the SV-COMP'13 benchmark:
 //   https://svn.sosy-lab.org/software/sv-benchmarks/trunk/c/pthread/stateful01_unsafe.c
 
-#include "libse.h"
+#include "bench.h"
 #include "concurrent/mutex.h"
 
 using namespace se::ops;
@@ -31,7 +31,7 @@ void f1() {
 }
 
 int main(void) {
-  slicer.begin_slice_loop();
+  se::begin_bench_slice_loop(slicer);
   do {
     se::Thread::encoders().reset();
 
@@ -44,6 +44,7 @@ int main(void) {
     se::Thread::error(i == 16 && j == 5);
 
     if (se::Thread::encode() && smt::sat == se::Thread::encoders().solver.check()) {
+      se::report_first_bug(slicer);
       return 0;
     }
   } while (slicer.next_slice());
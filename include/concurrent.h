@@ -32,6 +32,13 @@ std::unique_ptr<ReadInstr<T>> alloc_read_instr(const SharedVar<T>& shared_var) {
     make_read_event<T>(shared_var.zone())));
 }
 
+template<typename T, size_t N>
+std::unique_ptr<ReadInstr<T[N]>> alloc_read_instr(
+  const SharedVar<T[N]>& shared_var) {
+
+  return shared_var.m_var.make_read_instr();
+}
+
 template<typename Range, typename Domain, size_t N>
 std::unique_ptr<ReadInstr<Range>> alloc_read_instr(
   SharedMemory<Range, Domain, N>&& shared_memory) {
@@ -55,6 +62,70 @@ std::unique_ptr<ReadInstr<typename
     literal, ThisThread::path_condition_ptr()));
 }
 
+/// Unary read instruction, folded if the operand is a literal
+template<Opcode opcode, typename T>
+std::unique_ptr<ReadInstr<typename ReturnType<opcode, T>::result_type>>
+  make_unary_read_instr(std::unique_ptr<ReadInstr<T>> instr) {
+
+  typedef typename ReturnType<opcode, T>::result_type Result;
+
+  const LiteralReadInstr<T>* const literal_ptr =
+    dynamic_cast<const LiteralReadInstr<T>*>(instr.get());
+  if (literal_ptr) {
+    return std::unique_ptr<ReadInstr<Result>>(new LiteralReadInstr<Result>(
+      Eval<opcode>::eval(literal_ptr->literal()), instr->condition_ptr()));
+  }
+
+  return std::unique_ptr<ReadInstr<Result>>(
+    new UnaryReadInstr<opcode, T>(std::move(instr)));
+}
+
+/// Condition under which both operands of an instruction are read
+
+/// A null pointer stands for a condition that is always true.
+inline std::shared_ptr<ReadInstr<bool>> conjoin_conditions(
+  const std::shared_ptr<ReadInstr<bool>>& lcondition_ptr,
+  const std::shared_ptr<ReadInstr<bool>>& rcondition_ptr) {
+
+  if (lcondition_ptr == rcondition_ptr || !rcondition_ptr) {
+    return lcondition_ptr;
+  }
+
+  if (!lcondition_ptr) {
+    return rcondition_ptr;
+  }
+
+  NaryReadInstr<LAND, bool>::OperandPtrs condition_ptrs;
+  condition_ptrs.push_front(rcondition_ptr);
+  condition_ptrs.push_front(lcondition_ptr);
+  return std::make_shared<NaryReadInstr<LAND, bool>>(
+    std::move(condition_ptrs), 2);
+}
+
+/// Binary read instruction, folded if both operands are literals
+
+/// The folded literal is guarded by the conditions of both operands.
+template<Opcode opcode, typename T, typename U>
+std::unique_ptr<ReadInstr<typename ReturnType<opcode, T, U>::result_type>>
+  make_binary_read_instr(std::unique_ptr<ReadInstr<T>> linstr,
+    std::unique_ptr<ReadInstr<U>> rinstr) {
+
+  typedef typename ReturnType<opcode, T, U>::result_type Result;
+
+  const LiteralReadInstr<T>* const lliteral_ptr =
+    dynamic_cast<const LiteralReadInstr<T>*>(linstr.get());
+  const LiteralReadInstr<U>* const rliteral_ptr =
+    dynamic_cast<const LiteralReadInstr<U>*>(rinstr.get());
+  if (lliteral_ptr && rliteral_ptr) {
+    return std::unique_ptr<ReadInstr<Result>>(new LiteralReadInstr<Result>(
+      Eval<opcode>::eval(lliteral_ptr->literal(), rliteral_ptr->literal()),
+      conjoin_conditions(linstr->condition_ptr(), rinstr->condition_ptr())));
+  }
+
+  return std::unique_ptr<ReadInstr<Result>>(new BinaryReadInstr<opcode, T, U>(
+    std::move(linstr), std::move(rinstr)));
+}
+
 template<typename T> struct UnwrapType<LocalVar<T>> { typedef T base; };
 template<typename T> struct UnwrapType<SharedVar<T>> { typedef T base; };
 
@@ -69,8 +140,7 @@ namespace ops
   inline auto operator op(std::unique_ptr<ReadInstr<T>> instr) ->\
     std::unique_ptr<ReadInstr<typename ReturnType<opcode, T>::result_type>> {\
     \
-    return std::unique_ptr<ReadInstr<typename ReturnType<opcode, T>::result_type>>(\
-      new UnaryReadInstr<opcode, T>(std::move(instr)));\
+    return make_unary_read_instr<opcode, T>(std::move(instr));\
   }\
 
 #define CONCURRENT_BINARY_OP(op, opcode) \
@@ -121,8 +191,8 @@ namespace ops
     std::unique_ptr<ReadInstr<U>> rinstr) ->\
     std::unique_ptr<ReadInstr<typename ReturnType<opcode, T, U>::result_type>> {\
     \
-    return std::unique_ptr<ReadInstr<typename ReturnType<opcode, T, U>::result_type>>(\
-      new BinaryReadInstr<opcode, T, U>(std::move(linstr), std::move(rinstr)));\
+    return make_binary_read_instr<opcode, T, U>(std::move(linstr),\
+      std::move(rinstr));\
   }\
 
 CONCURRENT_UNARY_OP(!, NOT)
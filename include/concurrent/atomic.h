@@ -0,0 +1,33 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_ATOMIC_H_
+#define LIBSE_ATOMIC_H_
+
+#include "concurrent.h"
+
+namespace se {
+
+/// Scope whose shared memory accesses are indivisible
+
+/// An Atomic object marks all the events that the current thread records
+/// during the object's lifetime as a single atomic section. The encoder
+/// gives such a section one clock so that no event in another thread can
+/// happen in between any two events of the section. This models, for
+/// example, hardware-atomic blocks. Atomic scopes may be nested in which
+/// case they are part of the most outer one.
+///
+/// \remark An Atomic object must be destroyed by the thread that created it
+class Atomic {
+public:
+  Atomic() { ThisThread::begin_atomic(); }
+  ~Atomic() { ThisThread::end_atomic(); }
+
+  Atomic(const Atomic&) = delete;
+  Atomic& operator=(const Atomic&) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_BARRIER_H_
+#define LIBSE_BARRIER_H_
+
+#include <unordered_map>
+
+#include "concurrent.h"
+
+namespace se {
+
+/// Symbolic thread barrier
+
+/// Every thread that calls wait() on a Barrier object blocks until as many
+/// threads as the barrier has participants have arrived at the barrier. The
+/// barrier can be reused: the i-th call of wait() in one thread synchronizes
+/// with the i-th call in every other thread. The order encoder directly makes
+/// such calls simultaneous rather than unwinding a spin loop. If fewer
+/// threads than participants arrive, none of them leaves the barrier, and
+/// more threads than participants must never call wait() for the i-th time.
+class Barrier {
+private:
+  // unique atom that identifies the barrier
+  const Zone m_zone;
+
+  // number of threads that must arrive before any of them leaves
+  const unsigned m_count;
+
+  // Per-thread number of calls to wait()
+  std::unordered_map<ThreadId, unsigned> m_generations;
+
+public:
+  /// Barrier for `count` threads, which must be positive
+  Barrier(unsigned count) :
+    m_zone(Zone::unique_atom()),
+    m_count(count),
+    m_generations() {
+
+    assert(0 < m_count);
+  }
+
+  Barrier(const Barrier&) = delete;
+  Barrier& operator=(const Barrier&) = delete;
+
+  /// Block until all other threads have arrived at the barrier
+  void wait() {
+    const ThreadId thread_id = ThisThread::thread_id();
+    Threads::slice_append(thread_id, std::make_shared<BarrierEvent>(thread_id,
+      m_zone, m_generations[thread_id]++, m_count,
+      ThisThread::path_condition_ptr()));
+  }
+};
+
+}
+
+#endif
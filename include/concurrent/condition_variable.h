@@ -0,0 +1,80 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_CONDITION_VARIABLE_H_
+#define LIBSE_CONDITION_VARIABLE_H_
+
+#include "concurrent/mutex.h"
+
+namespace se {
+
+/// Symbolic condition variable
+
+/// A thread that waits on a ConditionVariable object releases the given
+/// mutex, blocks until another thread notifies the condition variable and
+/// then reacquires the mutex. Unlike std::condition_variable, there are no
+/// spurious wakeups, and a notification is lost if no thread is waiting.
+class ConditionVariable {
+private:
+  // unique atom that identifies the condition variable
+  const Zone m_zone;
+
+public:
+  ConditionVariable() : m_zone(Zone::unique_atom()) {}
+
+  ConditionVariable(const ConditionVariable&) = delete;
+  ConditionVariable& operator=(const ConditionVariable&) = delete;
+
+  /// Block until notified
+
+  /// \pre: ThisThread holds the mutex
+  void wait(Mutex& mutex) {
+    const ThreadId thread_id = ThisThread::thread_id();
+
+    mutex.unlock();
+
+    const std::shared_ptr<WaitEvent> wait_event_ptr(new WaitEvent(thread_id,
+      m_zone, ThisThread::path_condition_ptr()));
+    Threads::slice_append(thread_id, wait_event_ptr);
+    Threads::slice_append(thread_id, std::make_shared<WakeEvent>(thread_id,
+      wait_event_ptr, ThisThread::path_condition_ptr()));
+
+    mutex.lock();
+  }
+
+  /// Block until notified and the given predicate holds
+
+  /// Instead of waiting in a loop, the thread waits at most once, namely if
+  /// the predicate does not already hold, and the predicate must hold after
+  /// the thread has woken up.
+  ///
+  /// \param predicate - function that returns a new boolean read instruction
+  ///
+  /// \pre: ThisThread holds the mutex
+  template<typename Predicate>
+  void wait(Mutex& mutex, Predicate predicate) {
+    ThisThread::begin_then(std::shared_ptr<ReadInstr<bool>>(!predicate()));
+    wait(mutex);
+    ThisThread::await(predicate());
+    ThisThread::end_branch();
+  }
+
+  /// Wake up at most one waiting thread
+  void notify_one() {
+    const ThreadId thread_id = ThisThread::thread_id();
+    Threads::slice_append(thread_id, std::make_shared<NotifyEvent>(thread_id,
+      m_zone, false, ThisThread::path_condition_ptr()));
+  }
+
+  /// Wake up all waiting threads
+  void notify_all() {
+    const ThreadId thread_id = ThisThread::thread_id();
+    Threads::slice_append(thread_id, std::make_shared<NotifyEvent>(thread_id,
+      m_zone, true, ThisThread::path_condition_ptr()));
+  }
+};
+
+}
+
+#endif
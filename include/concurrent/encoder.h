@@ -6,6 +6,7 @@
 #define LIBSE_CONCURRENT_ENCODER_H_
 
 #include <unordered_set>
+#include <unordered_map>
 
 #include "core/op.h"
 #include "concurrent/instr.h"
@@ -24,36 +25,80 @@ typedef smt::Bv<unsigned short> ClockSort;
 typedef smt::Int ClockSort;
 #endif
 
+/// Point in time of an event
+
+/// All the events in the same atomic section share the term of the section's
+/// clock. Their order among each other is statically known from the position
+/// of each event in the atomic section.
 class Clock
 {
 private:
   ClockSort m_term;
 
+  // zero if and only if the clock is not in an atomic section
+  unsigned m_atomic_section;
+
+  // position in the atomic section
+  unsigned m_atomic_index;
+
+  bool is_same_atomic_section(
+    const Clock& y) const
+  {
+    return m_atomic_section != 0 && m_atomic_section == y.m_atomic_section;
+  }
+
 public:
   Clock(const ClockSort& term)
-  : m_term(term) {}
+  : m_term(term),
+    m_atomic_section(0),
+    m_atomic_index(0) {}
+
+  /// Clock in the given non-zero atomic section
+  Clock(const ClockSort& term, unsigned atomic_section, unsigned atomic_index)
+  : m_term(term),
+    m_atomic_section(atomic_section),
+    m_atomic_index(atomic_index)
+  {
+    assert(atomic_section != 0);
+  }
 
   Clock(const Clock& other)
-  : m_term(other.m_term) {}
+  : m_term(other.m_term),
+    m_atomic_section(other.m_atomic_section),
+    m_atomic_index(other.m_atomic_index) {}
 
   Clock(Clock&& other)
-  : m_term(std::move(other.m_term)) {}
+  : m_term(std::move(other.m_term)),
+    m_atomic_section(other.m_atomic_section),
+    m_atomic_index(other.m_atomic_index) {}
 
   smt::Bool happens_before(
     const Clock& y) const
   {
+    if (is_same_atomic_section(y)) {
+      return smt::literal<smt::Bool>(m_atomic_index < y.m_atomic_index);
+    }
+
     return m_term < y.m_term;
   }
 
   smt::Bool simultaneous(
     const Clock& y) const
   {
+    if (is_same_atomic_section(y)) {
+      return smt::literal<smt::Bool>(m_atomic_index == y.m_atomic_index);
+    }
+
     return m_term == y.m_term;
   }
 
   smt::Bool simultaneous_or_happens_before(
     const Clock& y) const
   {
+    if (is_same_atomic_section(y)) {
+      return smt::literal<smt::Bool>(m_atomic_index <= y.m_atomic_index);
+    }
+
     return m_term <= y.m_term;
   }
 
@@ -62,37 +107,71 @@ public:
     return m_term;
   }
 
+  /// \returns zero if the clock is not in an atomic section
+  unsigned atomic_section() const
+  {
+    return m_atomic_section;
+  }
+
+  unsigned atomic_index() const
+  {
+    return m_atomic_index;
+  }
+
+  /// Next position in the same atomic section
+
+  /// \pre: clock is in an atomic section
+  Clock atomic_successor() const
+  {
+    assert(m_atomic_section != 0);
+    return Clock(m_term, m_atomic_section, m_atomic_index + 1);
+  }
+
   Clock& operator=(const Clock& other)
   {
     m_term = other.m_term;
+    m_atomic_section = other.m_atomic_section;
+    m_atomic_index = other.m_atomic_index;
     return *this;
   }
 };
 
-class Encoders {
-public:
-  // logic must support uninterpreted functions and
-  // uses bit vectors only if __USE_BV__ is defined
-  smt::Z3Solver solver;
+/// Builder of terms that never adds constraints to a solver
 
-private:
+/// Since smt::UnsafeTerm objects are independent of any solver, the terms
+/// of a TermFactory can be added to the solver of any Encoders. Clocks are
+/// built without their lower bounds, which Encoders adds to its solver.
+class TermFactory {
+protected:
   const std::string m_rf_prefix;
+  const std::string m_wake_prefix;
   const std::string m_sup_clock_prefix;
   const std::string m_clock_prefix;
   const std::string m_join_clock_prefix;
+  const std::string m_context_clock_prefix;
+  const std::string m_context_thread_prefix;
   const std::string m_event_prefix;
+  const std::string m_pending_rf_prefix;
+  const std::string m_pop_prefix;
+  const std::string m_pending_pop_prefix;
   const Clock m_epoch;
 
+  // identifier of the most recent atomic section, zero if there is none
+  unsigned m_atomic_section;
+  const std::string m_atomic_clock_prefix;
+
+  // clocks of events in atomic sections
+  std::unordered_map<EventId, Clock> m_atomic_clocks;
+
+private:
   friend class ValueEncoder;
   friend class ReadInstrEncoder;
 
-  template<typename T> friend smt::UnsafeTerm ReadEvent<T>::constant(Encoders&) const;
-  template<typename T> friend smt::UnsafeTerm DirectWriteEvent<T>::constant(Encoders&) const;
+  template<typename T> friend smt::UnsafeTerm ReadEvent<T>::constant(TermFactory&) const;
+  template<typename T> friend smt::UnsafeTerm DirectWriteEvent<T>::constant(TermFactory&) const;
 
   template<typename T, typename U, size_t N>
-  friend smt::UnsafeTerm IndirectWriteEvent<T, U, N>::constant(Encoders&) const;
-
-  unsigned m_join_id;
+  friend smt::UnsafeTerm IndirectWriteEvent<T, U, N>::constant(TermFactory&) const;
 
   std::string create_symbol(const Event& event) {
     return m_event_prefix + std::to_string(event.event_id());
@@ -111,6 +190,10 @@ private:
     return smt::any<smt::Bool>(create_symbol(event));
   }
 
+  smt::UnsafeTerm constant(const WriteEvent<bool>& event) {
+    return smt::any<smt::Bool>(create_symbol(event));
+  }
+
   template<typename T, size_t N>
   smt::UnsafeTerm constant(const ReadEvent<T[N]>& event) {
     return create_array_constant<T, N>(event);
@@ -127,25 +210,26 @@ private:
   }
 
 public:
-  Encoders()
-#ifdef __USE_BV__
-  : solver(smt::QF_AUFBV_LOGIC),
-#else
-  : solver(smt::QF_AUFLIA_LOGIC),
-#endif
+  TermFactory() :
     m_rf_prefix("rf_"),
+    m_wake_prefix("wake_"),
     m_sup_clock_prefix("sup-clock_"),
     m_clock_prefix("clock_"),
     m_join_clock_prefix("join-clock_"),
+    m_context_clock_prefix("context-clock_"),
+    m_context_thread_prefix("context-thread_"),
     m_event_prefix("event_"),
+    m_pending_rf_prefix("pending-rf_"),
+    m_pop_prefix("pop_"),
+    m_pending_pop_prefix("pending-pop_"),
 #ifndef __USE_MATRIX
     m_epoch(smt::literal<ClockSort>(0)),
 #endif
-    m_join_id(0) {}
+    m_atomic_section(0),
+    m_atomic_clock_prefix("atomic-clock_"),
+    m_atomic_clocks() {}
 
-  void reset() {
-    solver.reset();
-  }
+  virtual ~TermFactory() {}
 
   /// Creates a Z3 constant according to the event's \ref Event::type() "type"
   smt::UnsafeTerm constant(const Event& event) {
@@ -158,19 +242,6 @@ public:
     return smt::constant(decl);
   }
 
-  Clock join_clocks(
-    const Clock& x,
-    const Clock& y)
-  {
-#ifndef __USE_MATRIX__
-    const std::string join_name = m_join_clock_prefix + std::to_string(m_join_id++);
-    const Clock join_clock(smt::any<ClockSort>(join_name));
-    solver.add(m_epoch.happens_before(join_clock));
-    solver.add(x.happens_before(join_clock) && y.happens_before(join_clock));
-    return join_clock;
-#endif
-  }
-
   /// Equality between write event and read event applied to function `rf`
 
   /// \returns `w == rf(r)`, i.e. `r` reads from `w`
@@ -187,35 +258,91 @@ public:
     return smt::any<ClockSort>(m_rf_prefix + create_symbol(read_event));
   }
 
-  /// Unique clock constraint for an event
-  Clock clock(const Event& event) {
-#ifndef __USE_MATRIX__
-    const Clock clock(smt::any<ClockSort>(m_clock_prefix + create_symbol(event)));
-    solver.add(m_epoch.happens_before(clock));
-    return clock;
-#endif
+  /// Equality between notify event and wake event applied to `wake`
+
+  /// \returns `n == wake(w)`, i.e. `w` has been woken up by `n`
+  smt::UnsafeTerm wake(const NotifyEvent& notify_event,
+    const WakeEvent& wake_event) {
+
+    return notify_event.event_id() == wake_clock(wake_event);
   }
 
-  void transitivity(const std::unordered_set<std::shared_ptr<Event>>& event_ptrs)
-  {
-/*    for (const std::shared_ptr<Event>& x : event_ptrs) {
-      for (const std::shared_ptr<Event>& y : event_ptrs) {
-        for (const std::shared_ptr<Event>& z : event_ptrs) {
-          solver.add(smt::implies(clock(*x) <= clock(*y) and clock(*y) <= clock(*z),
-            clock(*x) <= clock(*z)));
-        }
-      }
+  ClockSort wake_clock(const WakeEvent& wake_event) {
+    return smt::any<ClockSort>(m_wake_prefix + create_symbol(wake_event));
+  }
+
+  /// Point in time at which the given context starts
+  Clock context_clock(unsigned context) {
+    return Clock(smt::any<ClockSort>(m_context_clock_prefix +
+      std::to_string(context)));
+  }
+
+  /// Identifier of the only thread that runs in the given context
+  ClockSort context_thread(unsigned context) {
+    return smt::any<ClockSort>(m_context_thread_prefix +
+      std::to_string(context));
+  }
+
+  /// Forget the clocks of all events in atomic sections
+  void clear_atomic_clocks() {
+    m_atomic_clocks.clear();
+  }
+
+  /// Associate an event with the given clock in an atomic section
+  void set_atomic_clock(const Event& event, const Clock& clock) {
+    assert(clock.atomic_section() != 0);
+    m_atomic_clocks.erase(event.event_id());
+    m_atomic_clocks.insert(std::make_pair(event.event_id(), clock));
+  }
+
+  /// Unique clock of an event
+
+  /// The clock's lower bound is only added to the solver by Encoders.
+  virtual Clock clock(const Event& event) {
+    const std::unordered_map<EventId, Clock>::const_iterator iter =
+      m_atomic_clocks.find(event.event_id());
+    if (iter != m_atomic_clocks.cend()) {
+      return iter->second;
     }
-*/
+
+    return Clock(smt::any<ClockSort>(m_clock_prefix + create_symbol(event)));
   }
 
-  /// Individual array element literal
+  /// Array literal
+
+  /// A uniform array is a single constant array term. Otherwise, every
+  /// element that differs from LiteralReadInstr<T>::element_literal() is
+  /// stored into such a constant array. The size of the term is therefore
+  /// independent of the array size.
   template<typename T, size_t N = std::extent<T>::value,
     class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
   smt::UnsafeTerm literal(const LiteralReadInstr<T>& instr) {
 
     typedef typename std::remove_extent<T>::type ElementType;
-    return literal(LiteralReadInstr<ElementType>(instr.element_literal()));
+    const smt::UnsafeTerm element_expr(literal(
+      LiteralReadInstr<ElementType>(instr.element_literal())));
+
+#ifdef __USE_BV__
+    smt::UnsafeTerm array_expr(smt::const_array<smt::Bv<size_t>>(element_expr));
+#else
+    smt::UnsafeTerm array_expr(smt::const_array<smt::Int>(element_expr));
+#endif
+
+    for (const std::pair<size_t, ElementType>& element_store :
+      instr.element_stores()) {
+
+#ifdef __USE_BV__
+      const smt::UnsafeTerm index_expr(
+        smt::literal<smt::Bv<size_t>>(element_store.first));
+#else
+      const smt::UnsafeTerm index_expr(
+        smt::literal<smt::Int>(element_store.first));
+#endif
+      array_expr = smt::store(array_expr, index_expr, literal(
+        LiteralReadInstr<ElementType>(element_store.second)));
+    }
+
+    return array_expr;
   }
 
   smt::UnsafeTerm literal(const LiteralReadInstr<bool>& instr) {
@@ -238,6 +365,126 @@ public:
 
     return Clock(smt::any<ClockSort>(m_sup_clock_prefix + create_symbol(read_event)));
   }
+
+  /// Literal under which a read may read from a write that is encoded later
+
+  /// See Z3OrderEncoderC0::encode_increment()
+  smt::Bool pending_rf(const Event& read_event, unsigned generation) {
+    assert(read_event.is_read());
+
+    return smt::any<smt::Bool>(m_pending_rf_prefix + create_symbol(read_event) +
+      "_" + std::to_string(generation));
+  }
+
+  /// Literal that implies that some read of the zone atom reads from the write
+  smt::Bool popped(const Event& write_event, unsigned atom) {
+    assert(write_event.is_write());
+
+    return smt::any<smt::Bool>(m_pop_prefix + create_symbol(write_event) +
+      "_" + std::to_string(atom));
+  }
+
+  /// Literal under which a write may be read by a read that is encoded later
+
+  /// See Z3OrderEncoderC0::encode_increment()
+  smt::Bool pending_pop(const Event& write_event, unsigned atom,
+    unsigned generation) {
+
+    assert(write_event.is_write());
+
+    return smt::any<smt::Bool>(m_pending_pop_prefix + create_symbol(write_event) +
+      "_" + std::to_string(atom) + "_" + std::to_string(generation));
+  }
+};
+
+/// Terms together with the solver to which their constraints are added
+class Encoders : public TermFactory {
+public:
+  // logic must support uninterpreted functions and
+  // uses bit vectors only if __USE_BV__ is defined
+  smt::Z3Solver solver;
+
+private:
+  unsigned m_join_id;
+
+public:
+  Encoders()
+#ifdef __USE_BV__
+  : TermFactory(),
+    solver(smt::QF_AUFBV_LOGIC),
+#else
+  : TermFactory(),
+    solver(smt::QF_AUFLIA_LOGIC),
+#endif
+    m_join_id(0) {}
+
+  void reset() {
+    solver.reset();
+    clear_atomic_clocks();
+  }
+
+  Clock join_clocks(
+    const Clock& x,
+    const Clock& y)
+  {
+    if (x.atomic_section() != 0 && x.atomic_section() == y.atomic_section()) {
+      return x.atomic_index() < y.atomic_index() ? y : x;
+    }
+
+#ifndef __USE_MATRIX__
+    const std::string join_name = m_join_clock_prefix + std::to_string(m_join_id++);
+    const Clock join_clock(smt::any<ClockSort>(join_name));
+    solver.add(m_epoch.happens_before(join_clock));
+    solver.add(x.happens_before(join_clock) && y.happens_before(join_clock));
+    return join_clock;
+#endif
+  }
+
+  /// Fresh clock that happens after the given one
+  Clock later_clock(const Clock& x) {
+#ifndef __USE_MATRIX__
+    const std::string later_name = m_join_clock_prefix + std::to_string(m_join_id++);
+    const Clock later_clock(smt::any<ClockSort>(later_name));
+    solver.add(m_epoch.happens_before(later_clock));
+    solver.add(x.happens_before(later_clock));
+    return later_clock;
+#endif
+  }
+
+  /// Clock of a new atomic section whose events are indivisible
+  Clock atomic_clock() {
+    m_atomic_section++;
+
+    const Clock clock(smt::any<ClockSort>(m_atomic_clock_prefix +
+      std::to_string(m_atomic_section)), m_atomic_section, 0);
+    solver.add(m_epoch.happens_before(clock));
+    return clock;
+  }
+
+  /// Unique clock constraint for an event
+  Clock clock(const Event& event) {
+    const bool is_atomic = m_atomic_clocks.count(event.event_id()) != 0;
+    const Clock clock(TermFactory::clock(event));
+#ifndef __USE_MATRIX__
+    if (!is_atomic) {
+      solver.add(m_epoch.happens_before(clock));
+    }
+#endif
+    return clock;
+  }
+
+  void transitivity(const std::unordered_set<std::shared_ptr<Event>>& event_ptrs)
+  {
+/*    for (const std::shared_ptr<Event>& x : event_ptrs) {
+      for (const std::shared_ptr<Event>& y : event_ptrs) {
+        for (const std::shared_ptr<Event>& z : event_ptrs) {
+          solver.add(smt::implies(clock(*x) <= clock(*y) and clock(*y) <= clock(*z),
+            clock(*x) <= clock(*z)));
+        }
+      }
+    }
+*/
+  }
 };
 
 template<Opcode opcode, typename T>
@@ -260,28 +507,28 @@ public:
   ReadInstrEncoder() {}
 
   template<typename T>
-  smt::UnsafeTerm encode(const LiteralReadInstr<T>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const LiteralReadInstr<T>& instr, TermFactory& helper) const {
     return helper.literal(instr);
   }
 
   template<typename T>
-  smt::UnsafeTerm encode(const BasicReadInstr<T>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const BasicReadInstr<T>& instr, TermFactory& helper) const {
     return helper.constant(*instr.event_ptr());
   }
 
   template<Opcode opcode, typename T>
-  smt::UnsafeTerm encode(const UnaryReadInstr<opcode, T>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const UnaryReadInstr<opcode, T>& instr, TermFactory& helper) const {
     return Eval<opcode>::eval(instr.operand_ref().encode(*this, helper));
   }
 
   template<Opcode opcode, typename T, typename U>
-  smt::UnsafeTerm encode(const BinaryReadInstr<opcode, T, U>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const BinaryReadInstr<opcode, T, U>& instr, TermFactory& helper) const {
     return Eval<opcode>::eval(instr.loperand_ref().encode(*this, helper),
       instr.roperand_ref().encode(*this, helper));
   }
 
   template<Opcode opcode, typename T>
-  smt::UnsafeTerm encode(const NaryReadInstr<opcode, T>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const NaryReadInstr<opcode, T>& instr, TermFactory& helper) const {
     smt::UnsafeTerm nary_expr = Z3Identity<opcode, T>::constant();
     for (const std::shared_ptr<ReadInstr<T>>& operand_ptr : instr.operand_ptrs()) {
       nary_expr = Eval<opcode>::eval(nary_expr, operand_ptr->encode(*this, helper));
@@ -290,14 +537,29 @@ public:
   }
 
   template<typename T, typename U, size_t N>
-  smt::UnsafeTerm encode(const DerefReadInstr<T[N], U>& instr, Encoders& helper) const {
+  smt::UnsafeTerm encode(const DerefReadInstr<T[N], U>& instr, TermFactory& helper) const {
     return smt::select(instr.memory_ref().encode(*this, helper),
       instr.offset_ref().encode(*this, helper));
   }
+
+  template<typename T, size_t N>
+  smt::UnsafeTerm encode(const ElementsReadInstr<T[N]>& instr, TermFactory& helper) const {
+    smt::UnsafeTerm array_expr(instr.operand_ptrs().front()->encode(*this, helper));
+    for (size_t index = 1; index < N; index++) {
+#ifdef __USE_BV__
+      const smt::UnsafeTerm index_expr(smt::literal<smt::Bv<size_t>>(index));
+#else
+      const smt::UnsafeTerm index_expr(smt::literal<smt::Int>(index));
+#endif
+      array_expr = smt::store(array_expr, index_expr, smt::select(
+        instr.operand_ptrs()[index]->encode(*this, helper), index_expr));
+    }
+    return array_expr;
+  }
 };
 
 #define READ_ENCODER_FN_DEF \
-  encode(const ReadInstrEncoder& encoder, Encoders& helper) const {\
+  encode(const ReadInstrEncoder& encoder, TermFactory& helper) const {\
     return encoder.encode(*this, helper);\
   }
 
@@ -317,6 +579,9 @@ smt::UnsafeTerm NaryReadInstr<opcode, T>::READ_ENCODER_FN_DEF
 template<typename T, typename U, size_t N>
 smt::UnsafeTerm DerefReadInstr<T[N], U>::READ_ENCODER_FN_DEF
 
+template<typename T, size_t N>
+smt::UnsafeTerm ElementsReadInstr<T[N]>::READ_ENCODER_FN_DEF
+
 /// Encoder for the values of direct and indirect write events
 
 /// Every `encode_eq(...)` member function returns a Z3 expression whose sort
@@ -328,7 +593,7 @@ private:
   template<typename T, typename U, size_t N>
   smt::UnsafeTerm encode_indirect_write(const DerefReadInstr<T[N], U>& instr,
     const ReadInstrEncoder& read_encoder,
-    const smt::UnsafeTerm& rhs_expr, Encoders& helper) const {
+    const smt::UnsafeTerm& rhs_expr, TermFactory& helper) const {
 
     return smt::store(instr.memory_ref().encode(read_encoder, helper),
       instr.offset_ref().encode(read_encoder, helper), rhs_expr);
@@ -338,38 +603,31 @@ public:
   ValueEncoder() : m_read_encoder() {}
 
   template<typename T>
-  smt::UnsafeTerm encode_eq(const ReadEvent<T>& event, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const ReadEvent<T>& event, TermFactory& helper) const {
     return smt::literal<smt::Bool>(false);
   }
 
-  smt::UnsafeTerm encode_eq(const SyncEvent& event, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const SyncEvent& event, TermFactory& helper) const {
     return smt::literal<smt::Bool>(true);
   }
 
   template<typename T>
-  smt::UnsafeTerm encode_eq(const DirectWriteEvent<T>& event, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const DirectWriteEvent<T>& event, TermFactory& helper) const {
     smt::UnsafeTerm lhs_expr(helper.constant(event));
     smt::UnsafeTerm rhs_expr(event.instr_ref().encode(m_read_encoder, helper));
     return lhs_expr == rhs_expr;
   }
 
+  /// Array initialization as a single equality between array terms
   template<typename T, size_t N>
-  smt::UnsafeTerm encode_eq(const DirectWriteEvent<T[N]>& event, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const DirectWriteEvent<T[N]>& event, TermFactory& helper) const {
     smt::UnsafeTerm lhs_expr(helper.constant(event));
     smt::UnsafeTerm init_expr(event.instr_ref().encode(m_read_encoder, helper));
-    smt::UnsafeTerm and_expr(smt::literal<smt::Bool>(true));
-    for (size_t i = 0; i < N; i++) {
-#if __USE_BV__
-      and_expr = and_expr && (smt::select(lhs_expr, smt::literal<smt::Bv<size_t>>(i)) == init_expr);
-#else
-      and_expr = and_expr && (smt::select(lhs_expr, smt::literal<smt::Int>(i)) == init_expr);
-#endif
-    }
-    return and_expr;
+    return lhs_expr == init_expr;
   }
 
   template<typename T, typename U, size_t N>
-  smt::UnsafeTerm encode_eq(const IndirectWriteEvent<T, U, N>& event, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const IndirectWriteEvent<T, U, N>& event, TermFactory& helper) const {
     smt::UnsafeTerm lhs_expr(helper.constant(event));
     smt::UnsafeTerm rhs_expr(event.instr_ref().encode(m_read_encoder, helper));
     return lhs_expr == encode_indirect_write(event.deref_instr_ref(),
@@ -377,18 +635,18 @@ public:
   }
 
   template<typename T>
-  smt::UnsafeTerm encode_eq(std::unique_ptr<ReadInstr<T>> instr_ptr, Encoders& encoders) const {
+  smt::UnsafeTerm encode_eq(std::unique_ptr<ReadInstr<T>> instr_ptr, TermFactory& encoders) const {
     return instr_ptr->encode(m_read_encoder, encoders);
   }
 };
 
 #define VALUE_ENCODER_FN_DEF \
-  encode_eq(const ValueEncoder& encoder, Encoders& helper) const {\
+  encode_eq(const ValueEncoder& encoder, TermFactory& helper) const {\
     return encoder.encode_eq(*this, helper);\
   }
 
 #define CONSTANT_ENCODER_FN_DEF \
-  constant(Encoders& helper) const { return helper.constant(*this); }
+  constant(TermFactory& helper) const { return helper.constant(*this); }
 
 template<typename T>
 smt::UnsafeTerm ReadEvent<T>::VALUE_ENCODER_FN_DEF
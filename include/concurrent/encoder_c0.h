@@ -6,6 +6,14 @@
 #define LIBSE_CONCURRENT_ENCODER_C0_H_
 
 #include <string>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include <forward_list>
+#include <unordered_set>
+#include <unordered_map>
 #include <smt>
 
 #include "concurrent/encoder.h"
@@ -273,11 +281,161 @@ public:
 
 /* Alex's quartic encoding for collection data types such as stacks etc. */
 
+/// \internal Solver-independent expressions over the order of events
+
+/// Every expression is identified by its index, and the operands of an
+/// expression always have smaller indexes than the expression itself.
+/// Building an expression only appends to plain vectors and never touches
+/// smt::UnsafeTerm objects or any solver context. Thus, different threads can
+/// build their own OrderExprs at the same time, as long as the events are
+/// not modified meanwhile. Z3OrderEncoderC0::translate() turns expressions
+/// into terms on a single thread.
+class OrderExprs {
+public:
+  typedef size_t Index;
+
+  enum Opcode {
+    LITERAL,
+    NOT,
+    AND,
+    OR,
+    IMPLIES,
+    // clock(x) < clock(y)
+    HAPPENS_BEFORE,
+    // y reads from x
+    RF,
+    // x and y have the same value
+    EQUAL_VALUES,
+    // condition of x
+    CONDITION,
+    // the events have pairwise distinct clocks
+    DISTINCT_CLOCKS,
+    // the events have pairwise distinct rf clocks
+    DISTINCT_RF_CLOCKS
+  };
+
+  struct Expr {
+    Opcode opcode;
+
+    // only for LITERAL
+    bool literal;
+
+    // events of binary and unary expressions over events
+    const Event* x_ptr;
+    const Event* y_ptr;
+
+    // operand indexes in [begin, end) of operands(), or events in
+    // [begin, end) of event_ptrs() for DISTINCT_CLOCKS and DISTINCT_RF_CLOCKS
+    size_t begin;
+    size_t end;
+  };
+
+private:
+  std::vector<Expr> m_exprs;
+  std::vector<Index> m_operands;
+  std::vector<const Event*> m_event_ptrs;
+
+  Index append(Opcode opcode, const Event* x_ptr, const Event* y_ptr,
+    size_t begin = 0, size_t end = 0) {
+
+    const Expr expr = { opcode, false, x_ptr, y_ptr, begin, end };
+    m_exprs.push_back(expr);
+    return m_exprs.size() - 1;
+  }
+
+  Index append_nary(Opcode opcode, const std::vector<Index>& operands) {
+    const size_t begin = m_operands.size();
+    m_operands.insert(m_operands.end(), operands.cbegin(), operands.cend());
+    return append(opcode, nullptr, nullptr, begin, m_operands.size());
+  }
+
+  Index append_events(Opcode opcode, const std::vector<const Event*>& event_ptrs) {
+    const size_t begin = m_event_ptrs.size();
+    m_event_ptrs.insert(m_event_ptrs.end(), event_ptrs.cbegin(),
+      event_ptrs.cend());
+    return append(opcode, nullptr, nullptr, begin, m_event_ptrs.size());
+  }
+
+public:
+  OrderExprs() : m_exprs(), m_operands(), m_event_ptrs() {}
+
+  size_t size() const { return m_exprs.size(); }
+  const Expr& expr(Index index) const { return m_exprs[index]; }
+  const std::vector<Index>& operands() const { return m_operands; }
+  const std::vector<const Event*>& event_ptrs() const { return m_event_ptrs; }
+
+  Index literal(bool literal) {
+    const Index index = append(LITERAL, nullptr, nullptr);
+    m_exprs[index].literal = literal;
+    return index;
+  }
+
+  Index negation(Index operand) {
+    return append_nary(NOT, std::vector<Index>(1, operand));
+  }
+
+  /// \returns true if there are no operands
+  Index conjunction(const std::vector<Index>& operands) {
+    return append_nary(AND, operands);
+  }
+
+  /// \returns false if there are no operands
+  Index disjunction(const std::vector<Index>& operands) {
+    return append_nary(OR, operands);
+  }
+
+  Index implication(Index antecedent, Index consequent) {
+    std::vector<Index> operands;
+    operands.push_back(antecedent);
+    operands.push_back(consequent);
+    return append_nary(IMPLIES, operands);
+  }
+
+  Index happens_before(const Event& x, const Event& y) {
+    return append(HAPPENS_BEFORE, &x, &y);
+  }
+
+  Index rf(const Event& write_event, const Event& read_event) {
+    assert(write_event.is_write());
+    assert(read_event.is_read());
+    return append(RF, &write_event, &read_event);
+  }
+
+  Index equal_values(const Event& x, const Event& y) {
+    return append(EQUAL_VALUES, &x, &y);
+  }
+
+  /// \returns true if the event is unconditional
+  Index condition(const Event& event) {
+    if (!event.condition_ptr()) {
+      return literal(true);
+    }
+
+    return append(CONDITION, &event, nullptr);
+  }
+
+  Index distinct_clocks(const std::vector<const Event*>& event_ptrs) {
+    return append_events(DISTINCT_CLOCKS, event_ptrs);
+  }
+
+  Index distinct_rf_clocks(const std::vector<const Event*>& read_event_ptrs) {
+    return append_events(DISTINCT_RF_CLOCKS, read_event_ptrs);
+  }
+};
+
+/// \internal Mutexes, as a join of their zones, that protect memory events
+
+/// A memory event that is not protected by any mutex need not be mapped.
+/// A write that happens before every thread creation, such as when the
+/// main thread initializes a shared variable, is mapped to the bottom zone:
+/// it is ordered before all other writes anyway, so it needs no mutex.
+typedef std::unordered_map<const Event*, Zone> Locksets;
+
 class Z3OrderEncoderC0 {
 private:
   const ReadInstrEncoder m_read_encoder;
 
-  smt::UnsafeTerm event_condition(const Event& event, Encoders& encoders) const {
+  smt::UnsafeTerm event_condition(const Event& event, TermFactory& encoders) const {
     if (event.condition_ptr()) {
       return event.condition_ptr()->encode(m_read_encoder, encoders);
     }
@@ -288,20 +446,160 @@ private:
   typedef std::shared_ptr<Event> EventPtr;
   typedef std::unordered_set<EventPtr> EventPtrSet;
 
+  // are all the given events, except those that happen before every thread
+  // creation, protected by the same mutex?
+  static bool is_protected(const EventPtrSet& event_ptrs,
+    const Locksets& locksets) {
+
+    bool has_common_lockset = false;
+    std::set<unsigned> common_lockset;
+    for (const EventPtr& event_ptr : event_ptrs) {
+      const Locksets::const_iterator iter = locksets.find(event_ptr.get());
+      if (iter == locksets.cend()) {
+        return false;
+      }
+
+      const std::set<unsigned>& lockset = iter->second.m_atoms;
+      if (lockset.empty()) { continue; }
+
+      if (has_common_lockset) {
+        std::set<unsigned>::const_iterator atom_iter = common_lockset.cbegin();
+        while (atom_iter != common_lockset.cend()) {
+          if (lockset.count(*atom_iter) == 0) {
+            atom_iter = common_lockset.erase(atom_iter);
+          } else {
+            ++atom_iter;
+          }
+        }
+      } else {
+        common_lockset = lockset;
+        has_common_lockset = true;
+      }
+
+      if (common_lockset.empty()) {
+        return false;
+      }
+    }
+
+    return has_common_lockset;
+  }
+
 public:
   Z3OrderEncoderC0() : m_read_encoder() {}
 
+  /// \internal Terms of the given expression and all those before it
+
+  /// The expressions are translated in the order of their indexes, so the
+  /// terms of the operands are always at hand. Events in the same atomic
+  /// section share the section's clock term, so such events only count once
+  /// towards OrderExprs::DISTINCT_CLOCKS.
+  smt::UnsafeTerm translate(const OrderExprs& exprs, OrderExprs::Index root,
+    TermFactory& encoders) const {
+
+    assert(root < exprs.size());
+
+    const std::vector<OrderExprs::Index>& operands = exprs.operands();
+    std::vector<smt::UnsafeTerm> terms;
+    terms.reserve(root + 1);
+    for (OrderExprs::Index index = 0; index <= root; index++) {
+      const OrderExprs::Expr& expr = exprs.expr(index);
+      switch (expr.opcode) {
+      case OrderExprs::LITERAL:
+        terms.push_back(smt::literal<smt::Bool>(expr.literal));
+        break;
+      case OrderExprs::NOT:
+        terms.push_back(not terms[operands[expr.begin]]);
+        break;
+      case OrderExprs::AND:
+      case OrderExprs::OR:
+        {
+          const bool is_and = expr.opcode == OrderExprs::AND;
+          smt::UnsafeTerm nary_term(smt::literal<smt::Bool>(is_and));
+          for (size_t i = expr.begin; i < expr.end; i++) {
+            if (is_and) {
+              nary_term = nary_term and terms[operands[i]];
+            } else {
+              nary_term = nary_term or terms[operands[i]];
+            }
+          }
+          terms.push_back(nary_term);
+        }
+        break;
+      case OrderExprs::IMPLIES:
+        terms.push_back(smt::implies(terms[operands[expr.begin]],
+          terms[operands[expr.begin + 1]]));
+        break;
+      case OrderExprs::HAPPENS_BEFORE:
+        terms.push_back(encoders.clock(*expr.x_ptr).happens_before(
+          encoders.clock(*expr.y_ptr)));
+        break;
+      case OrderExprs::RF:
+        terms.push_back(encoders.rf(*expr.x_ptr, *expr.y_ptr));
+        break;
+      case OrderExprs::EQUAL_VALUES:
+        terms.push_back(expr.x_ptr->constant(encoders) ==
+          expr.y_ptr->constant(encoders));
+        break;
+      case OrderExprs::CONDITION:
+        terms.push_back(event_condition(*expr.x_ptr, encoders));
+        break;
+      case OrderExprs::DISTINCT_CLOCKS:
+        {
+          smt::UnsafeTerms ptrs;
+          ptrs.reserve(expr.end - expr.begin);
+
+          std::unordered_set<unsigned> atomic_sections;
+          for (size_t i = expr.begin; i < expr.end; i++) {
+            const Clock clock(encoders.clock(*exprs.event_ptrs()[i]));
+            if (clock.atomic_section() != 0 &&
+                !atomic_sections.insert(clock.atomic_section()).second) {
+              continue;
+            }
+
+            ptrs.push_back(clock.term());
+          }
+
+          if (1 < ptrs.size()) {
+            terms.push_back(smt::distinct(std::move(ptrs)));
+          } else {
+            terms.push_back(smt::literal<smt::Bool>(true));
+          }
+        }
+        break;
+      case OrderExprs::DISTINCT_RF_CLOCKS:
+        {
+          smt::UnsafeTerms ptrs;
+          ptrs.reserve(expr.end - expr.begin);
+          for (size_t i = expr.begin; i < expr.end; i++) {
+            ptrs.push_back(encoders.rf_clock(*exprs.event_ptrs()[i]));
+          }
+
+          if (1 < ptrs.size()) {
+            terms.push_back(smt::distinct(std::move(ptrs)));
+          } else {
+            terms.push_back(smt::literal<smt::Bool>(true));
+          }
+        }
+        break;
+      }
+    }
+
+    return terms[root];
+  }
+
   /// \internal \return every pop is associated with a push
-  smt::UnsafeTerm rf_enc(const ZoneRelation<Event>& relation, Encoders& encoders) const {
-    smt::UnsafeTerm rf_expr(smt::literal<smt::Bool>(true));
+  OrderExprs::Index rf_exprs(const ZoneRelation<Event>& relation,
+    OrderExprs& exprs) const {
+
+    std::vector<OrderExprs::Index> rf_operands;
     for (const EventPtr& x_ptr : relation.event_ptrs()) {
       if (x_ptr->is_write()) { continue; }
       const Event& read_event = *x_ptr;
 
       assert(!read_event.zone().is_bottom());
-      const smt::UnsafeTerm read_event_condition(event_condition(read_event, encoders));
+      const OrderExprs::Index read_event_condition(exprs.condition(read_event));
 
-      smt::UnsafeTerm wr_schedules(smt::literal<smt::Bool>(false));
+      std::vector<OrderExprs::Index> wr_schedules;
       for (const EventPtr& y_ptr : relation.event_ptrs()) {
         if (y_ptr->is_read()) { continue; }
         const Event& write_event = *y_ptr;
@@ -309,22 +607,53 @@ public:
         assert(!write_event.zone().is_bottom());
         if (read_event.zone().meet(write_event.zone()).is_bottom()) { continue; }
 
-        const smt::UnsafeTerm wr_order(
-          encoders.clock(write_event).happens_before(encoders.clock(read_event)));
+        const OrderExprs::Index wr_schedule(exprs.rf(write_event, read_event));
+        std::vector<OrderExprs::Index> wr_consequents;
+        wr_consequents.push_back(exprs.happens_before(write_event, read_event));
+        wr_consequents.push_back(exprs.condition(write_event));
+        wr_consequents.push_back(exprs.equal_values(write_event, read_event));
 
-        const smt::UnsafeTerm wr_schedule(encoders.rf(write_event, read_event));
-        const smt::UnsafeTerm wr_equality(write_event.constant(encoders) ==
-          read_event.constant(encoders));
-        const smt::UnsafeTerm write_event_condition(event_condition(write_event, encoders));
+        wr_schedules.push_back(wr_schedule);
+        rf_operands.push_back(exprs.implication(wr_schedule,
+          exprs.conjunction(wr_consequents)));
+      }
 
-        wr_schedules = wr_schedules or wr_schedule;
-        rf_expr = rf_expr and smt::implies(wr_schedule, wr_order and
-          write_event_condition and wr_equality);
+      rf_operands.push_back(exprs.implication(read_event_condition,
+        exprs.disjunction(wr_schedules)));
+    }
+    return exprs.conjunction(rf_operands);
+  }
+
+  smt::UnsafeTerm rf_enc(const ZoneRelation<Event>& relation, TermFactory& encoders) const {
+    OrderExprs exprs;
+    return translate(exprs, rf_exprs(relation, exprs), encoders);
+  }
+
+  /// \internal \return every read returns the value of some write
+
+  /// This over-approximates rf_enc() by ignoring when events happen: any
+  /// read may return the value of any write by any thread to the same zone,
+  /// even a write that happens after the read.
+  smt::UnsafeTerm unordered_rf_enc(const ZoneRelation<Event>& relation, Encoders& encoders) const {
+    smt::UnsafeTerm unordered_rf_expr(smt::literal<smt::Bool>(true));
+    for (const EventPtr& x_ptr : relation.event_ptrs()) {
+      if (x_ptr->is_write()) { continue; }
+      const Event& read_event = *x_ptr;
+
+      smt::UnsafeTerm some_write(smt::literal<smt::Bool>(false));
+      for (const EventPtr& y_ptr : relation.event_ptrs()) {
+        if (y_ptr->is_read()) { continue; }
+        const Event& write_event = *y_ptr;
+        if (read_event.zone().meet(write_event.zone()).is_bottom()) { continue; }
+
+        some_write = some_write or (event_condition(write_event, encoders) and
+          write_event.constant(encoders) == read_event.constant(encoders));
       }
 
-      rf_expr = rf_expr and smt::implies(read_event_condition, wr_schedules);
+      unordered_rf_expr = unordered_rf_expr and smt::implies(
+        event_condition(read_event, encoders), some_write);
     }
-    return rf_expr;
+    return unordered_rf_expr;
   }
 
   /// \internal \return FR axiom encoding
@@ -369,10 +698,12 @@ public:
   }
 
   /// \internal \return stack axiom (quartic)
-  smt::UnsafeTerm stack_enc(const ZoneRelation<Event>& relation, Encoders& encoders) const {
+  OrderExprs::Index stack_exprs(const ZoneRelation<Event>& relation,
+    OrderExprs& exprs) const {
+
     const ZoneAtomSet& zone_atoms = relation.zone_atoms();
 
-    smt::UnsafeTerm fr_expr(smt::literal<smt::Bool>(true));
+    std::vector<OrderExprs::Index> stack_operands;
     for (const Zone& zone : zone_atoms) {
       const std::pair<EventPtrSet, EventPtrSet> result =
         relation.partition(zone);
@@ -389,13 +720,13 @@ public:
           assert(!write_event_x.zone().is_bottom());
           assert(!write_event_y.zone().is_bottom());
 
-          const smt::UnsafeTerm xy_order(encoders.clock(write_event_x).happens_before(encoders.clock(write_event_y)));
+          const OrderExprs::Index xy_order(exprs.happens_before(write_event_x, write_event_y));
           for (const EventPtr& read_event_ptr_p : read_event_ptrs) {
             const Event& read_event_p = *read_event_ptr_p;
-            const smt::UnsafeTerm xp_schedule(encoders.rf(write_event_x, read_event_p));
-            const smt::UnsafeTerm yp_order(encoders.clock(write_event_y).happens_before(encoders.clock(read_event_p)));
+            const OrderExprs::Index xp_schedule(exprs.rf(write_event_x, read_event_p));
+            const OrderExprs::Index yp_order(exprs.happens_before(write_event_y, read_event_p));
 
-            smt::UnsafeTerm some_rf(smt::literal<smt::Bool>(false));
+            std::vector<OrderExprs::Index> yq_schedules;
             for (const EventPtr& read_event_ptr_q : read_event_ptrs) {
               if (read_event_ptr_p == read_event_ptr_q) { continue; }
 
@@ -404,74 +735,110 @@ public:
               assert(!read_event_p.zone().is_bottom());
               assert(!read_event_q.zone().is_bottom());
 
-              const smt::UnsafeTerm yq_schedule(encoders.rf(write_event_y, read_event_q));
-              const smt::UnsafeTerm qp_order(encoders.clock(read_event_q).happens_before(encoders.clock(read_event_p)));
+              const OrderExprs::Index yq_schedule(exprs.rf(write_event_y, read_event_q));
+              const OrderExprs::Index qp_order(exprs.happens_before(read_event_q, read_event_p));
 
-              fr_expr = fr_expr and
-                smt::implies(xy_order and xp_schedule and yq_schedule, qp_order);
-              some_rf = some_rf or yq_schedule;
+              std::vector<OrderExprs::Index> antecedents;
+              antecedents.push_back(xy_order);
+              antecedents.push_back(xp_schedule);
+              antecedents.push_back(yq_schedule);
+              stack_operands.push_back(exprs.implication(
+                exprs.conjunction(antecedents), qp_order));
+              yq_schedules.push_back(yq_schedule);
             }
 
-            const smt::UnsafeTerm y_condition(event_condition(write_event_y, encoders));
-            fr_expr = fr_expr and smt::implies(xp_schedule and xy_order and yp_order and y_condition, some_rf);
+            std::vector<OrderExprs::Index> antecedents;
+            antecedents.push_back(xp_schedule);
+            antecedents.push_back(xy_order);
+            antecedents.push_back(yp_order);
+            antecedents.push_back(exprs.condition(write_event_y));
+            stack_operands.push_back(exprs.implication(
+              exprs.conjunction(antecedents), exprs.disjunction(yq_schedules)));
           }
         }
       }
     }
 
-    return fr_expr;
+    return exprs.conjunction(stack_operands);
+  }
+
+  smt::UnsafeTerm stack_enc(const ZoneRelation<Event>& relation, TermFactory& encoders) const {
+    OrderExprs exprs;
+    return translate(exprs, stack_exprs(relation, exprs), encoders);
   }
 
   /// \internal \return total order on pushes 
-  smt::UnsafeTerm ws_enc(const ZoneRelation<Event>& relation, Encoders& encoders) const {
+
+  /// Writes in the same atomic section are already ordered by their
+  /// position in the section, and they share the section's clock term.
+  ///
+  /// If all the writes to a zone atom are protected by the same mutex,
+  /// except those that happen before every thread creation, they are in
+  /// critical sections that mutex_enc() already orders. Since
+  /// no two writes that occur can then happen at the same time, the zone
+  /// atom needs no constraint.
+  OrderExprs::Index ws_exprs(const ZoneRelation<Event>& relation,
+    const Locksets& locksets, OrderExprs& exprs) const {
+
     const ZoneAtomSet& zone_atoms = relation.zone_atoms();
 
-    smt::UnsafeTerm ws_expr(smt::literal<smt::Bool>(true));
+    std::vector<OrderExprs::Index> ws_operands;
     for (const Zone& zone : zone_atoms) {
       const EventPtrSet write_event_ptrs = relation.find(zone,
         WriteEventPredicate::predicate());
+      if (write_event_ptrs.size() < 2) { continue; }
+      if (is_protected(write_event_ptrs, locksets)) { continue; }
 
-      smt::UnsafeTerms ptrs;
+      std::vector<const Event*> ptrs;
       ptrs.reserve(write_event_ptrs.size());
-
       for (const EventPtr& write_event_ptr : write_event_ptrs) {
-        const Event& write_event = *write_event_ptr;
-        ptrs.push_back(encoders.clock(write_event).term());
+        ptrs.push_back(write_event_ptr.get());
       }
 
-      if (1 < ptrs.size()) {
-        const smt::UnsafeTerm zone_ws_expr(smt::distinct(std::move(ptrs)));
-        ws_expr = ws_expr and zone_ws_expr;
-      }
+      ws_operands.push_back(exprs.distinct_clocks(ptrs));
     }
 
-    return ws_expr;
+    return exprs.conjunction(ws_operands);
+  }
+
+  smt::UnsafeTerm ws_enc(const ZoneRelation<Event>& relation,
+    const Locksets& locksets, TermFactory& encoders) const {
+
+    OrderExprs exprs;
+    return translate(exprs, ws_exprs(relation, locksets, exprs), encoders);
+  }
+
+  smt::UnsafeTerm ws_enc(const ZoneRelation<Event>& relation, TermFactory& encoders) const {
+    return ws_enc(relation, Locksets(), encoders);
   }
 
   /// \internal \return injective read-from
-  smt::UnsafeTerm rs_enc(const ZoneRelation<Event>& relation, Encoders& encoders) const {
+  OrderExprs::Index rs_exprs(const ZoneRelation<Event>& relation,
+    OrderExprs& exprs) const {
+
     const ZoneAtomSet& zone_atoms = relation.zone_atoms();
 
-    smt::UnsafeTerm rs_expr(smt::literal<smt::Bool>(true));
+    std::vector<OrderExprs::Index> rs_operands;
     for (const Zone& zone : zone_atoms) {
       const EventPtrSet read_event_ptrs = relation.find(zone,
         ReadEventPredicate::predicate());
+      if (read_event_ptrs.size() < 2) { continue; }
 
-      smt::UnsafeTerms ptrs;
+      std::vector<const Event*> ptrs;
       ptrs.reserve(read_event_ptrs.size());
-
       for (const EventPtr& read_event_ptr : read_event_ptrs) {
-        const Event& read_event = *read_event_ptr;
-        ptrs.push_back(encoders.rf_clock(read_event));
+        ptrs.push_back(read_event_ptr.get());
       }
 
-      if (1 < ptrs.size()) {
-        const smt::UnsafeTerm zone_rs_expr(smt::distinct(std::move(ptrs)));
-        rs_expr = rs_expr and zone_rs_expr;
-      }
+      rs_operands.push_back(exprs.distinct_rf_clocks(ptrs));
     }
 
-    return rs_expr;
+    return exprs.conjunction(rs_operands);
+  }
+
+  smt::UnsafeTerm rs_enc(const ZoneRelation<Event>& relation, TermFactory& encoders) const {
+    OrderExprs exprs;
+    return translate(exprs, rs_exprs(relation, exprs), encoders);
   }
 
   void encode_without_ws(const ZoneRelation<Event>& zone_relation, Encoders& encoders) const
@@ -482,11 +849,660 @@ public:
   }
 
   void encode(const ZoneRelation<Event>& zone_relation, Encoders& encoders) const
+  {
+    encode(zone_relation, Locksets(), encoders);
+  }
+
+  /// Same as encode(const ZoneRelation<Event>&, Encoders&) but with the
+  /// mutexes that protect the events, see ws_enc()
+  void encode(const ZoneRelation<Event>& zone_relation,
+    const Locksets& locksets, Encoders& encoders) const
   {
     encode_without_ws(zone_relation, encoders);
-    encoders.solver.unsafe_add(ws_enc(zone_relation, encoders));
+    encoders.solver.unsafe_add(ws_enc(zone_relation, locksets, encoders));
     encoders.solver.unsafe_add(rs_enc(zone_relation, encoders));
   }
+
+  /// Same as encode(const ZoneRelation<Event>&, const Locksets&, Encoders&)
+  /// but on `jobs` threads
+
+  /// The \ref ZoneRelation::components() "components" of the relation are
+  /// distributed round-robin over the jobs. Each job builds the axioms of
+  /// its components as OrderExprs, which involves neither smt::UnsafeTerm
+  /// objects nor any solver. The zone atoms of every component are computed
+  /// before the jobs start, so the jobs only read the components and the
+  /// given locksets. Finally, the calling thread translates the expressions
+  /// of all jobs into terms and adds them to the given solver.
+  void encode(const ZoneRelation<Event>& zone_relation, unsigned jobs,
+    const Locksets& locksets, Encoders& encoders) const
+  {
+    assert(0 < jobs);
+
+    const std::vector<ZoneRelation<Event>> components(zone_relation.components());
+    if (jobs == 1 || components.size() < 2) {
+      encode(zone_relation, locksets, encoders);
+      return;
+    }
+
+    if (components.size() < jobs) {
+      jobs = components.size();
+    }
+
+    // fill the cache of every component while only this thread runs
+    for (const ZoneRelation<Event>& component : components) {
+      component.zone_atoms();
+    }
+
+    std::vector<OrderExprs> job_exprs(jobs);
+    std::vector<OrderExprs::Index> job_roots(jobs);
+    std::vector<std::thread> workers;
+    for (unsigned job = 0; job < jobs; job++) {
+      workers.emplace_back([this, job, jobs, &components, &job_exprs,
+          &job_roots, &locksets] {
+        OrderExprs& exprs = job_exprs[job];
+
+        std::vector<OrderExprs::Index> job_operands;
+        for (size_t i = job; i < components.size(); i += jobs) {
+          const ZoneRelation<Event>& component = components[i];
+          job_operands.push_back(rf_exprs(component, exprs));
+          job_operands.push_back(stack_exprs(component, exprs));
+          job_operands.push_back(ws_exprs(component, locksets, exprs));
+          job_operands.push_back(rs_exprs(component, exprs));
+        }
+
+        job_roots[job] = exprs.conjunction(job_operands);
+      });
+    }
+
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    for (unsigned job = 0; job < jobs; job++) {
+      encoders.solver.unsafe_add(translate(job_exprs[job], job_roots[job],
+        encoders));
+    }
+  }
+
+  /// Adds the axioms of encode(const ZoneRelation<Event>&, const Locksets&,
+  /// Encoders&) that involve at least one of the given new events
+
+  /// The relation must relate the new events as well as the events of all
+  /// earlier increments, which are numbered by their generation, starting
+  /// from zero. Since later increments relate further events, a read may
+  /// read from a write that is still to be encoded if its pending literal,
+  /// see TermFactory::pending_rf(), holds. Likewise, a write may be read by
+  /// a read that is still to be encoded if TermFactory::pending_pop() holds.
+  /// Every increment chains the pending literals of the previous generation
+  /// to the new events, so the axioms of earlier increments stay valid.
+  ///
+  /// Unlike ws_exprs(), writes are ordered pairwise, and a pair of writes
+  /// needs no constraint if both writes are protected by the same mutex.
+  /// The increment is encoded by the calling thread only.
+  ///
+  /// \returns assumption that no event is pending, which is only valid for
+  ///   the given generation and must therefore be added in a scope of the
+  ///   solver that is popped before the next increment
+  smt::UnsafeTerm encode_increment(const ZoneRelation<Event>& relation,
+    const std::unordered_set<std::shared_ptr<Event>>& new_event_ptrs,
+    unsigned generation, const Locksets& locksets, Encoders& encoders) const
+  {
+    assert(0 < generation ||
+      new_event_ptrs.size() == relation.event_ptrs().size());
+
+    const auto is_new = [&new_event_ptrs](const EventPtr& event_ptr) {
+      return new_event_ptrs.count(event_ptr) != 0;
+    };
+
+    std::vector<EventPtr> read_event_ptrs;
+    std::vector<EventPtr> write_event_ptrs;
+    for (const EventPtr& event_ptr : relation.event_ptrs()) {
+      if (event_ptr->is_read()) {
+        read_event_ptrs.push_back(event_ptr);
+      } else {
+        write_event_ptrs.push_back(event_ptr);
+      }
+    }
+
+    smt::UnsafeTerm increment_expr(smt::literal<smt::Bool>(true));
+    smt::UnsafeTerm no_pending_expr(smt::literal<smt::Bool>(true));
+
+    // see rf_exprs()
+    for (const EventPtr& read_event_ptr : read_event_ptrs) {
+      const Event& read_event = *read_event_ptr;
+      const bool is_new_read = is_new(read_event_ptr);
+
+      const smt::UnsafeTerm pending_rf(encoders.pending_rf(read_event,
+        generation));
+      smt::UnsafeTerm wr_schedules(pending_rf);
+      for (const EventPtr& write_event_ptr : write_event_ptrs) {
+        if (!is_new_read && !is_new(write_event_ptr)) { continue; }
+
+        const Event& write_event = *write_event_ptr;
+        if (read_event.zone().meet(write_event.zone()).is_bottom()) { continue; }
+
+        const smt::UnsafeTerm wr_schedule(encoders.rf(write_event, read_event));
+        const smt::UnsafeTerm wr_order(encoders.clock(write_event).
+          happens_before(encoders.clock(read_event)));
+        increment_expr = increment_expr and smt::implies(wr_schedule,
+          wr_order and event_condition(write_event, encoders) and
+          write_event.constant(encoders) == read_event.constant(encoders));
+        wr_schedules = wr_schedules or wr_schedule;
+      }
+
+      const smt::UnsafeTerm antecedent(is_new_read ?
+        event_condition(read_event, encoders) :
+        smt::UnsafeTerm(encoders.pending_rf(read_event, generation - 1)));
+      increment_expr = increment_expr and
+        smt::implies(antecedent, wr_schedules);
+      no_pending_expr = no_pending_expr and not pending_rf;
+    }
+
+    // see ws_exprs()
+    for (size_t i = 0; i < write_event_ptrs.size(); i++) {
+      const EventPtr& write_event_ptr_x = write_event_ptrs[i];
+      for (size_t j = i + 1; j < write_event_ptrs.size(); j++) {
+        const EventPtr& write_event_ptr_y = write_event_ptrs[j];
+        if (!is_new(write_event_ptr_x) && !is_new(write_event_ptr_y)) { continue; }
+        if (write_event_ptr_x->zone().meet(
+            write_event_ptr_y->zone()).is_bottom()) { continue; }
+
+        EventPtrSet write_event_ptr_pair;
+        write_event_ptr_pair.insert(write_event_ptr_x);
+        write_event_ptr_pair.insert(write_event_ptr_y);
+        if (is_protected(write_event_ptr_pair, locksets)) { continue; }
+
+        const smt::UnsafeTerm xy_simultaneous(encoders.clock(*write_event_ptr_x).
+          simultaneous(encoders.clock(*write_event_ptr_y)));
+        increment_expr = increment_expr and not xy_simultaneous;
+      }
+    }
+
+    // see rs_exprs()
+    for (size_t i = 0; i < read_event_ptrs.size(); i++) {
+      const EventPtr& read_event_ptr_p = read_event_ptrs[i];
+      for (size_t j = i + 1; j < read_event_ptrs.size(); j++) {
+        const EventPtr& read_event_ptr_q = read_event_ptrs[j];
+        if (!is_new(read_event_ptr_p) && !is_new(read_event_ptr_q)) { continue; }
+        if (read_event_ptr_p->zone().meet(
+            read_event_ptr_q->zone()).is_bottom()) { continue; }
+
+        const smt::UnsafeTerm pq_rf_clocks(encoders.rf_clock(*read_event_ptr_p) ==
+          encoders.rf_clock(*read_event_ptr_q));
+        increment_expr = increment_expr and not pq_rf_clocks;
+      }
+    }
+
+    // see stack_exprs(), except that the disjunction over the reads that may
+    // read from write y is replaced by TermFactory::popped(), defined below
+    for (const ZoneAtom& zone_atom : relation.zone_atoms()) {
+      const std::pair<EventPtrSet, EventPtrSet> result =
+        relation.partition(zone_atom);
+      const EventPtrSet& atom_read_event_ptrs = result.first;
+      const EventPtrSet& atom_write_event_ptrs = result.second;
+
+      for (const EventPtr& write_event_ptr_x : atom_write_event_ptrs) {
+        for (const EventPtr& write_event_ptr_y : atom_write_event_ptrs) {
+          if (write_event_ptr_x == write_event_ptr_y) { continue; }
+
+          const Event& write_event_x = *write_event_ptr_x;
+          const Event& write_event_y = *write_event_ptr_y;
+          const bool is_new_xy = is_new(write_event_ptr_x) ||
+            is_new(write_event_ptr_y);
+
+          const smt::UnsafeTerm xy_order(encoders.clock(write_event_x).
+            happens_before(encoders.clock(write_event_y)));
+          for (const EventPtr& read_event_ptr_p : atom_read_event_ptrs) {
+            const Event& read_event_p = *read_event_ptr_p;
+            const bool is_new_xyp = is_new_xy || is_new(read_event_ptr_p);
+            const smt::UnsafeTerm xp_schedule(encoders.rf(write_event_x,
+              read_event_p));
+
+            if (is_new_xyp) {
+              const smt::UnsafeTerm yp_order(encoders.clock(write_event_y).
+                happens_before(encoders.clock(read_event_p)));
+              increment_expr = increment_expr and smt::implies(xp_schedule and
+                xy_order and yp_order and event_condition(write_event_y, encoders),
+                smt::UnsafeTerm(encoders.popped(write_event_y, zone_atom)));
+            }
+
+            for (const EventPtr& read_event_ptr_q : atom_read_event_ptrs) {
+              if (read_event_ptr_p == read_event_ptr_q) { continue; }
+              if (!is_new_xyp && !is_new(read_event_ptr_q)) { continue; }
+
+              const Event& read_event_q = *read_event_ptr_q;
+              const smt::UnsafeTerm yq_schedule(encoders.rf(write_event_y,
+                read_event_q));
+              const smt::UnsafeTerm qp_order(encoders.clock(read_event_q).
+                happens_before(encoders.clock(read_event_p)));
+              increment_expr = increment_expr and smt::implies(xy_order and
+                xp_schedule and yq_schedule, qp_order);
+            }
+          }
+        }
+      }
+    }
+
+    // The popped literal of every write and each of its zone atoms is
+    // defined, not only those of the atoms that relation.zone_atoms()
+    // returns, because the atoms that it returns change as events are added.
+    std::unordered_map<unsigned, std::vector<EventPtr>> atom_read_event_ptrs;
+    for (const EventPtr& read_event_ptr : read_event_ptrs) {
+      for (unsigned atom : read_event_ptr->zone().atoms()) {
+        atom_read_event_ptrs[atom].push_back(read_event_ptr);
+      }
+    }
+
+    for (const EventPtr& write_event_ptr : write_event_ptrs) {
+      const Event& write_event = *write_event_ptr;
+      const bool is_new_write = is_new(write_event_ptr);
+
+      for (unsigned atom : write_event.zone().atoms()) {
+        const smt::UnsafeTerm pending_pop(encoders.pending_pop(write_event,
+          atom, generation));
+        smt::UnsafeTerm yq_schedules(pending_pop);
+
+        const std::unordered_map<unsigned, std::vector<EventPtr>>::const_iterator
+          iter = atom_read_event_ptrs.find(atom);
+        if (iter != atom_read_event_ptrs.cend()) {
+          for (const EventPtr& read_event_ptr : iter->second) {
+            if (!is_new_write && !is_new(read_event_ptr)) { continue; }
+
+            yq_schedules = yq_schedules or
+              encoders.rf(write_event, *read_event_ptr);
+          }
+        }
+
+        const smt::UnsafeTerm antecedent(is_new_write ?
+          encoders.popped(write_event, atom) :
+          encoders.pending_pop(write_event, atom, generation - 1));
+        increment_expr = increment_expr and
+          smt::implies(antecedent, yq_schedules);
+        no_pending_expr = no_pending_expr and not pending_pop;
+      }
+    }
+
+    encoders.solver.unsafe_add(increment_expr);
+    return no_pending_expr;
+  }
+
+  /// \internal \return every receive event happens after its send event
+
+  /// Forks and joins of threads are ordered directly by clocks rather than
+  /// linked up like memory accesses.
+  smt::UnsafeTerm fork_join_enc(
+    const std::forward_list<std::shared_ptr<ReceiveEvent>>& receive_event_ptrs,
+    Encoders& encoders) const {
+
+    smt::UnsafeTerm fork_join_expr(smt::literal<smt::Bool>(true));
+    for (const std::shared_ptr<ReceiveEvent>& receive_event_ptr : receive_event_ptrs) {
+      const ReceiveEvent& receive_event = *receive_event_ptr;
+      const SendEvent& send_event = receive_event.send_event_ref();
+
+      fork_join_expr = fork_join_expr and smt::implies(
+        event_condition(receive_event, encoders),
+        event_condition(send_event, encoders) and
+          encoders.clock(send_event).happens_before(encoders.clock(receive_event)));
+    }
+
+    return fork_join_expr;
+  }
+
+  /// \internal \return lexicographic order on interchangeable threads
+
+  /// Each element of symmetric_threads is a class of interchangeable threads,
+  /// given by the receive events that start them. Within a class, the i-th
+  /// thread starts no later than the (i+1)-th thread, which rules out the
+  /// symmetric schedules that only differ in the naming of the threads.
+  smt::UnsafeTerm symmetry_enc(
+    const std::forward_list<std::vector<std::shared_ptr<ReceiveEvent>>>& symmetric_threads,
+    Encoders& encoders) const {
+
+    smt::UnsafeTerm symmetry_expr(smt::literal<smt::Bool>(true));
+    for (const std::vector<std::shared_ptr<ReceiveEvent>>& receive_event_ptrs :
+         symmetric_threads) {
+
+      for (size_t i = 1; i < receive_event_ptrs.size(); i++) {
+        symmetry_expr = symmetry_expr and
+          encoders.clock(*receive_event_ptrs[i - 1]).simultaneous_or_happens_before(
+            encoders.clock(*receive_event_ptrs[i]));
+      }
+    }
+
+    return symmetry_expr;
+  }
+
+  /// \internal \return at most context_bound context switches
+
+  /// Time is divided into context_bound + 1 consecutive contexts, each of
+  /// which runs a single thread. Every memory access that occurs happens
+  /// in one of these contexts. Synchronization events are not constrained,
+  /// so a switch is only counted if it separates two memory accesses.
+  smt::UnsafeTerm context_bound_enc(
+    const std::vector<std::shared_ptr<Event>>& event_ptrs,
+    unsigned context_bound,
+    Encoders& encoders) const {
+
+    smt::UnsafeTerm context_expr(smt::literal<smt::Bool>(true));
+    for (unsigned context = 0; context < context_bound; context++) {
+      context_expr = context_expr and encoders.context_clock(context).
+        happens_before(encoders.context_clock(context + 1));
+    }
+
+    for (const std::shared_ptr<Event>& event_ptr : event_ptrs) {
+      const Event& event = *event_ptr;
+      const Clock clock(encoders.clock(event));
+
+      smt::UnsafeTerm some_context(smt::literal<smt::Bool>(false));
+      for (unsigned context = 0; context <= context_bound; context++) {
+        smt::UnsafeTerm in_context(event.thread_id() ==
+          encoders.context_thread(context));
+        in_context = in_context and encoders.context_clock(context).
+          simultaneous_or_happens_before(clock);
+        if (context < context_bound) {
+          in_context = in_context and clock.happens_before(
+            encoders.context_clock(context + 1));
+        }
+
+        some_context = some_context or in_context;
+      }
+
+      context_expr = context_expr and smt::implies(
+        event_condition(event, encoders), some_context);
+    }
+
+    return context_expr;
+  }
+
+  /// \internal \return cubes whose disjunction covers every reads-from choice
+
+  /// A read `r` splits the search space into one cube `rf(w, r)` for every
+  /// write `w` whose zone meets the zone of `r`, and one cube in which `r`
+  /// reads from none of them, e.g. because `r` does not occur. Reads with
+  /// more candidate writes are split first as long as the number of cubes
+  /// does not exceed max_cubes. Cubes are pairwise disjoint.
+  std::vector<smt::UnsafeTerm> rf_cubes(const ZoneRelation<Event>& relation,
+    size_t max_cubes, Encoders& encoders) const {
+
+    assert(0 < max_cubes);
+
+    typedef std::pair<EventPtr, std::vector<EventPtr>> Candidates;
+    std::vector<Candidates> reads;
+    for (const EventPtr& x_ptr : relation.event_ptrs()) {
+      if (x_ptr->is_write()) { continue; }
+
+      std::vector<EventPtr> write_event_ptrs;
+      for (const EventPtr& y_ptr : relation.event_ptrs()) {
+        if (y_ptr->is_read()) { continue; }
+        if (x_ptr->zone().meet(y_ptr->zone()).is_bottom()) { continue; }
+        write_event_ptrs.push_back(y_ptr);
+      }
+
+      if (write_event_ptrs.empty()) { continue; }
+
+      // event pointer sets are unordered but cubes should be reproducible
+      std::sort(write_event_ptrs.begin(), write_event_ptrs.end(),
+        [](const EventPtr& a, const EventPtr& b) {
+          return a->event_id() < b->event_id(); });
+      reads.push_back(Candidates(x_ptr, std::move(write_event_ptrs)));
+    }
+
+    std::sort(reads.begin(), reads.end(),
+      [](const Candidates& a, const Candidates& b) {
+        if (a.second.size() != b.second.size()) {
+          return a.second.size() > b.second.size();
+        }
+        return a.first->event_id() < b.first->event_id(); });
+
+    std::vector<smt::UnsafeTerm> cubes(1, smt::literal<smt::Bool>(true));
+    for (const Candidates& candidates : reads) {
+      if (max_cubes / cubes.size() < candidates.second.size() + 1) { continue; }
+
+      std::vector<smt::UnsafeTerm> split_cubes;
+      for (const smt::UnsafeTerm& cube : cubes) {
+        smt::UnsafeTerm no_rf(cube);
+        for (const EventPtr& write_event_ptr : candidates.second) {
+          const smt::UnsafeTerm wr_schedule(encoders.rf(*write_event_ptr,
+            *candidates.first));
+          split_cubes.push_back(cube and wr_schedule);
+          no_rf = no_rf and not wr_schedule;
+        }
+        split_cubes.push_back(no_rf);
+      }
+      cubes.swap(split_cubes);
+    }
+
+    return cubes;
+  }
+
+  /// \internal \return critical sections of the same mutex never overlap
+
+  /// Every unlock event determines a critical section that starts with its
+  /// \ref UnlockEvent::lock_event_ref() "lock event". Two critical sections
+  /// in different threads that protect the same mutex, as identified by the
+  /// zone of their mutex events, are ordered one after the other whenever
+  /// both of them occur. Critical sections in the same thread are already
+  /// ordered by program order.
+  smt::UnsafeTerm mutex_enc(
+    const std::forward_list<std::shared_ptr<UnlockEvent>>& unlock_event_ptrs,
+    Encoders& encoders) const {
+
+    typedef std::forward_list<std::shared_ptr<UnlockEvent>>::const_iterator
+      UnlockEventPtrIter;
+
+    smt::UnsafeTerm mutex_expr(smt::literal<smt::Bool>(true));
+    for (UnlockEventPtrIter x_iter = unlock_event_ptrs.cbegin();
+         x_iter != unlock_event_ptrs.cend(); x_iter++) {
+
+      const UnlockEvent& unlock_event_x = **x_iter;
+      const LockEvent& lock_event_x = unlock_event_x.lock_event_ref();
+      const smt::UnsafeTerm x_condition(event_condition(lock_event_x, encoders) and
+        event_condition(unlock_event_x, encoders));
+
+      for (UnlockEventPtrIter y_iter = std::next(x_iter);
+           y_iter != unlock_event_ptrs.cend(); y_iter++) {
+
+        const UnlockEvent& unlock_event_y = **y_iter;
+        if (unlock_event_x.thread_id() == unlock_event_y.thread_id()) { continue; }
+        if (unlock_event_x.zone() != unlock_event_y.zone()) { continue; }
+
+        const LockEvent& lock_event_y = unlock_event_y.lock_event_ref();
+        const smt::UnsafeTerm y_condition(event_condition(lock_event_y, encoders) and
+          event_condition(unlock_event_y, encoders));
+
+        const smt::UnsafeTerm xy_order(encoders.clock(unlock_event_x).happens_before(
+          encoders.clock(lock_event_y)));
+        const smt::UnsafeTerm yx_order(encoders.clock(unlock_event_y).happens_before(
+          encoders.clock(lock_event_x)));
+
+        mutex_expr = mutex_expr and
+          smt::implies(x_condition and y_condition, xy_order or yx_order);
+      }
+    }
+
+    return mutex_expr;
+  }
+
+  /// \internal \return threads leave a barrier together
+
+  /// Barrier events in different threads that wait at the same barrier, as
+  /// identified by their zone, for the same number of times form a group.
+  /// If the group has as many events as the barrier has participants, its
+  /// events either all occur or none of them does, and they are
+  /// simultaneous. Therefore, every event that precedes one of them in
+  /// program order happens before every event that succeeds the other. If
+  /// the group has fewer events, none of them can occur because the waiting
+  /// threads would block forever.
+  smt::UnsafeTerm barrier_enc(
+    const std::forward_list<std::shared_ptr<BarrierEvent>>& barrier_event_ptrs,
+    Encoders& encoders) const {
+
+    std::vector<std::vector<const BarrierEvent*>> groups;
+    for (const std::shared_ptr<BarrierEvent>& barrier_event_ptr : barrier_event_ptrs) {
+      const BarrierEvent& barrier_event = *barrier_event_ptr;
+      std::vector<std::vector<const BarrierEvent*>>::iterator iter =
+        std::find_if(groups.begin(), groups.end(),
+          [&barrier_event](const std::vector<const BarrierEvent*>& group) {
+            return group.front()->zone() == barrier_event.zone() &&
+              group.front()->generation() == barrier_event.generation();
+          });
+
+      if (iter == groups.end()) {
+        groups.emplace_back(1, &barrier_event);
+      } else {
+        iter->push_back(&barrier_event);
+      }
+    }
+
+    smt::UnsafeTerm barrier_expr(smt::literal<smt::Bool>(true));
+    for (const std::vector<const BarrierEvent*>& group : groups) {
+      const unsigned count = group.front()->count();
+
+      // more threads than participants must not wait at the same time,
+      // and each thread has at most one event per group
+      assert(group.size() <= count);
+
+      if (group.size() < count) {
+        for (const BarrierEvent* barrier_event_ptr : group) {
+          barrier_expr = barrier_expr and
+            not event_condition(*barrier_event_ptr, encoders);
+        }
+        continue;
+      }
+
+      for (size_t x = 0; x < group.size(); x++) {
+        const BarrierEvent& barrier_event_x = *group[x];
+        const smt::UnsafeTerm condition_x(event_condition(barrier_event_x, encoders));
+        for (size_t y = x + 1; y < group.size(); y++) {
+          const BarrierEvent& barrier_event_y = *group[y];
+          assert(barrier_event_x.thread_id() != barrier_event_y.thread_id());
+
+          const smt::UnsafeTerm condition_y(event_condition(barrier_event_y, encoders));
+          barrier_expr = barrier_expr and
+            smt::implies(condition_x, condition_y) and
+            smt::implies(condition_y, condition_x) and
+            smt::implies(condition_x, encoders.clock(barrier_event_x).simultaneous(
+              encoders.clock(barrier_event_y)));
+        }
+      }
+    }
+
+    return barrier_expr;
+  }
+
+  /// \internal \return every wakeup is preceded by a notification
+
+  /// A thread that waits on a condition variable wakes up after a notify
+  /// event of the same condition variable in another thread that occurs
+  /// while the thread is waiting. A notify event that does not notify all
+  /// threads wakes up at most one of them.
+  smt::UnsafeTerm condition_variable_enc(
+    const std::forward_list<std::shared_ptr<NotifyEvent>>& notify_event_ptrs,
+    const std::forward_list<std::shared_ptr<WakeEvent>>& wake_event_ptrs,
+    Encoders& encoders) const {
+
+    typedef std::forward_list<std::shared_ptr<WakeEvent>>::const_iterator
+      WakeEventPtrIter;
+
+    smt::UnsafeTerm cv_expr(smt::literal<smt::Bool>(true));
+    for (const std::shared_ptr<WakeEvent>& wake_event_ptr : wake_event_ptrs) {
+      const WakeEvent& wake_event = *wake_event_ptr;
+      const WaitEvent& wait_event = wake_event.wait_event_ref();
+
+      smt::UnsafeTerm some_wake(smt::literal<smt::Bool>(false));
+      for (const std::shared_ptr<NotifyEvent>& notify_event_ptr : notify_event_ptrs) {
+        const NotifyEvent& notify_event = *notify_event_ptr;
+        if (notify_event.thread_id() == wake_event.thread_id()) { continue; }
+        if (notify_event.zone() != wake_event.zone()) { continue; }
+
+        const smt::UnsafeTerm wake_schedule(encoders.wake(notify_event, wake_event));
+        some_wake = some_wake or wake_schedule;
+        cv_expr = cv_expr and smt::implies(wake_schedule,
+          event_condition(notify_event, encoders) and
+          encoders.clock(wait_event).happens_before(encoders.clock(notify_event)) and
+          encoders.clock(notify_event).happens_before(encoders.clock(wake_event)));
+      }
+
+      cv_expr = cv_expr and smt::implies(event_condition(wake_event, encoders),
+        some_wake);
+    }
+
+    for (const std::shared_ptr<NotifyEvent>& notify_event_ptr : notify_event_ptrs) {
+      const NotifyEvent& notify_event = *notify_event_ptr;
+      if (notify_event.is_all()) { continue; }
+
+      for (WakeEventPtrIter x_iter = wake_event_ptrs.cbegin();
+           x_iter != wake_event_ptrs.cend(); x_iter++) {
+
+        const WakeEvent& wake_event_x = **x_iter;
+        if (notify_event.zone() != wake_event_x.zone()) { continue; }
+
+        for (WakeEventPtrIter y_iter = std::next(x_iter);
+             y_iter != wake_event_ptrs.cend(); y_iter++) {
+
+          const WakeEvent& wake_event_y = **y_iter;
+          if (notify_event.zone() != wake_event_y.zone()) { continue; }
+
+          cv_expr = cv_expr and not (encoders.wake(notify_event, wake_event_x) and
+            encoders.wake(notify_event, wake_event_y));
+        }
+      }
+    }
+
+    return cv_expr;
+  }
+
+  void encode_unordered_rf(const ZoneRelation<Event>& zone_relation,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(unordered_rf_enc(zone_relation, encoders));
+  }
+
+  void encode_fork_joins(
+    const std::forward_list<std::shared_ptr<ReceiveEvent>>& receive_event_ptrs,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(fork_join_enc(receive_event_ptrs, encoders));
+  }
+
+  void encode_symmetric_threads(
+    const std::forward_list<std::vector<std::shared_ptr<ReceiveEvent>>>& symmetric_threads,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(symmetry_enc(symmetric_threads, encoders));
+  }
+
+  void encode_context_bound(
+    const std::vector<std::shared_ptr<Event>>& event_ptrs,
+    unsigned context_bound,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(context_bound_enc(event_ptrs, context_bound,
+      encoders));
+  }
+
+  void encode_mutexes(
+    const std::forward_list<std::shared_ptr<UnlockEvent>>& unlock_event_ptrs,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(mutex_enc(unlock_event_ptrs, encoders));
+  }
+
+  void encode_barriers(
+    const std::forward_list<std::shared_ptr<BarrierEvent>>& barrier_event_ptrs,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(barrier_enc(barrier_event_ptrs, encoders));
+  }
+
+  void encode_condition_variables(
+    const std::forward_list<std::shared_ptr<NotifyEvent>>& notify_event_ptrs,
+    const std::forward_list<std::shared_ptr<WakeEvent>>& wake_event_ptrs,
+    Encoders& encoders) const
+  {
+    encoders.solver.unsafe_add(condition_variable_enc(notify_event_ptrs,
+      wake_event_ptrs, encoders));
+  }
 };
 
 
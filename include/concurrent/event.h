@@ -23,8 +23,9 @@ namespace se {
 template<typename T>
 class ReadInstr;
 
-class Encoders;
+class TermFactory;
 class ValueEncoder;
+class Fingerprint;
 
 // On 32-bit architectures, the maximal write event identifier is 2^30-1.
 // This upper limit stems from Z3 which aligns char pointers for symbol
@@ -49,7 +50,8 @@ typedef unsigned ThreadId;
 /// is said to be conditional; otherwise, it is said to be unconditional.
 class Event {
 private:
-  static unsigned s_next_id;
+  // counter of the current Session
+  static unsigned& next_id();
 
   const EventId m_event_id;
   const ThreadId m_thread_id;
@@ -72,7 +74,7 @@ protected:
   Event(ThreadId thread_id, const Zone& zone, bool is_read,
     const Type* const type_ptr,
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
-    m_event_id(s_next_id++), m_zone(zone), m_thread_id(thread_id),
+    m_event_id(next_id()++), m_zone(zone), m_thread_id(thread_id),
     m_is_read(is_read), m_type_ptr(type_ptr), m_condition_ptr(condition_ptr) {
 
     assert(type_ptr != nullptr);
@@ -99,7 +101,7 @@ protected:
   }
 
 public:
-  static void reset_id(unsigned id = 0) { s_next_id = id; }
+  static void reset_id(unsigned id = 0) { next_id() = id; }
 
   virtual ~Event() {}
 
@@ -121,15 +123,18 @@ public:
     return m_event_id == other.m_event_id;
   }
 
-  virtual smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, Encoders& helper) const = 0;
-  virtual smt::UnsafeTerm constant(Encoders& helper) const = 0;
+  virtual smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, TermFactory& helper) const = 0;
+  virtual smt::UnsafeTerm constant(TermFactory& helper) const = 0;
+
+  /// Append the event's structure modulo event identifiers
+  virtual void fingerprint(Fingerprint& fingerprint) const;
 };
 
 #define DECL_VALUE_ENCODER_C0_FN \
-  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, Encoders& helper) const;
+  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, TermFactory& helper) const;
 
 #define DECL_CONSTANT_ENCODER_C0_FN \
-  smt::UnsafeTerm constant(Encoders& helper) const;
+  smt::UnsafeTerm constant(TermFactory& helper) const;
 
 /// Event that writes to memory through a variable of type `T`
 template<typename T>
@@ -152,12 +157,14 @@ public:
   virtual ~WriteEvent() {}
 
   const ReadInstr<T>& instr_ref() const { return *m_instr_ptr; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
 };
 
 /// Direct memory write event
 
 /// If T is an array type, a direct write event has the effect of initializing
-/// every array element to the expression given by WriteEvent<T>::instr_ref().
+/// the entire array to the one given by WriteEvent<T>::instr_ref().
 template<typename T>
 class DirectWriteEvent : public WriteEvent<T> {
 public:
@@ -198,6 +205,8 @@ public:
     return *m_deref_instr_ptr;
   }
 
+  void fingerprint(Fingerprint& fingerprint) const;
+
   DECL_VALUE_ENCODER_C0_FN
   DECL_CONSTANT_ENCODER_C0_FN
 };
@@ -239,23 +248,228 @@ protected:
     Event(thread_id, zone, receive, &TypeInfo<Sync>::s_type, condition_ptr) {}
 };
 
-/// \internal Write event for thread synchronization
+/// \internal Event that blocks or unblocks threads
+
+/// Blocking events are ordered with respect to program order but they are
+/// never linked up with memory accesses. Instead, the order encoder directly
+/// constrains the clocks of such events. If the \ref Event::zone() "zone" of
+/// a blocking event is not bottom, it identifies the synchronization object.
+class BlockingEvent : public SyncEvent {
+protected:
+  BlockingEvent(ThreadId thread_id, const Zone& zone, bool is_read,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    SyncEvent(thread_id, zone, is_read, condition_ptr) {}
+};
 
-/// Synchronization occurs through a unique \ref Event::zone() "zone atom".
-class SendEvent : public SyncEvent {
+/// \internal Fork or termination of a thread
+class SendEvent : public BlockingEvent {
 public:
   SendEvent(ThreadId thread_id,
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
-    SyncEvent(thread_id, Zone::unique_atom(), false, condition_ptr) {}
+    BlockingEvent(thread_id, Zone::bottom(), false, condition_ptr) {}
+};
+
+/// \internal Start of a thread or join with another thread
+
+/// A receive event happens after its send event whenever it occurs.
+class ReceiveEvent : public BlockingEvent {
+private:
+  // never null
+  const std::shared_ptr<SendEvent> m_send_event_ptr;
+
+public:
+  /// Event that waits for the given send event
+  ReceiveEvent(ThreadId thread_id,
+    const std::shared_ptr<SendEvent>& send_event_ptr,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, Zone::bottom(), true, condition_ptr),
+    m_send_event_ptr(send_event_ptr) {
+
+    assert(nullptr != send_event_ptr);
+  }
+
+  const SendEvent& send_event_ref() const { return *m_send_event_ptr; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Start or end of an atomic section in a thread
+
+/// Atomic events are never linked up with other events. Every event with a
+/// non-bottom \ref Event::zone() "zone" between the start and end of an
+/// atomic section is indivisible from the others in the same section.
+class AtomicEvent : public SyncEvent {
+private:
+  const bool m_is_begin;
+
+public:
+  AtomicEvent(ThreadId thread_id, bool is_begin) :
+    SyncEvent(thread_id, Zone::bottom(), true), m_is_begin(is_begin) {}
+
+  /// Does the event start an atomic section?
+  bool is_begin() const { return m_is_begin; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Event that acquires or releases a mutex
+class MutexEvent : public BlockingEvent {
+protected:
+  MutexEvent(ThreadId thread_id, const Zone& zone, bool unlock,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, zone, unlock, condition_ptr) {}
 };
 
-/// \internal Read event for thread synchronization
-class ReceiveEvent : public SyncEvent {
+/// \internal Start of a critical section
+class LockEvent : public MutexEvent {
 public:
-  /// Event that reads from the given zone, preferably SendEvent::zone()
-  ReceiveEvent(ThreadId thread_id, const Zone& zone,
+  /// Event that acquires the mutex whose unique zone atom is given
+  LockEvent(ThreadId thread_id, const Zone& zone,
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
-    SyncEvent(thread_id, zone, true, condition_ptr) {}
+    MutexEvent(thread_id, zone, false, condition_ptr) {}
+};
+
+/// \internal End of a critical section
+class UnlockEvent : public MutexEvent {
+private:
+  // never null
+  const std::shared_ptr<LockEvent> m_lock_event_ptr;
+
+public:
+  /// Event that releases the mutex acquired by the given lock event
+
+  /// \pre: lock event must be in the same thread
+  UnlockEvent(ThreadId thread_id,
+    const std::shared_ptr<LockEvent>& lock_event_ptr,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    MutexEvent(thread_id, lock_event_ptr->zone(), true, condition_ptr),
+    m_lock_event_ptr(lock_event_ptr) {
+
+    assert(thread_id == lock_event_ptr->thread_id());
+  }
+
+  /// Lock event that starts the critical section
+  const LockEvent& lock_event_ref() const { return *m_lock_event_ptr; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Arrival of a thread at a barrier
+
+/// All threads that arrive at the same barrier for the same number of times
+/// leave it together, i.e. their barrier events are simultaneous.
+class BarrierEvent : public BlockingEvent {
+private:
+  // number of times the thread has already arrived at the barrier
+  const unsigned m_generation;
+
+  // number of threads that must arrive at the barrier
+  const unsigned m_count;
+
+public:
+  /// Event that waits at the barrier whose unique zone atom is given
+
+  /// \pre 0 < count
+  BarrierEvent(ThreadId thread_id, const Zone& zone, unsigned generation,
+    unsigned count,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, zone, true, condition_ptr),
+    m_generation(generation),
+    m_count(count) {
+
+    assert(0 < m_count);
+  }
+
+  unsigned generation() const { return m_generation; }
+
+  /// Number of participants of the barrier
+  unsigned count() const { return m_count; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Signal to threads that wait on a condition variable
+class NotifyEvent : public BlockingEvent {
+private:
+  const bool m_is_all;
+
+public:
+  /// Event that notifies the condition variable whose unique zone is given
+  NotifyEvent(ThreadId thread_id, const Zone& zone, bool is_all,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, zone, false, condition_ptr),
+    m_is_all(is_all) {}
+
+  /// Can the event wake up more than one waiting thread?
+  bool is_all() const { return m_is_all; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Start of waiting on a condition variable
+class WaitEvent : public BlockingEvent {
+public:
+  /// Event that waits on the condition variable whose unique zone is given
+  WaitEvent(ThreadId thread_id, const Zone& zone,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, zone, true, condition_ptr) {}
+};
+
+/// \internal End of waiting on a condition variable
+
+/// A thread only wakes up after another thread has notified the condition
+/// variable while the thread was waiting, i.e. there are no spurious wakeups.
+class WakeEvent : public BlockingEvent {
+private:
+  // never null
+  const std::shared_ptr<WaitEvent> m_wait_event_ptr;
+
+public:
+  /// Event that stops waiting as started by the given wait event
+
+  /// \pre: wait event must be in the same thread
+  WakeEvent(ThreadId thread_id,
+    const std::shared_ptr<WaitEvent>& wait_event_ptr,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    BlockingEvent(thread_id, wait_event_ptr->zone(), true, condition_ptr),
+    m_wait_event_ptr(wait_event_ptr) {
+
+    assert(thread_id == wait_event_ptr->thread_id());
+  }
+
+  /// Wait event that starts the waiting
+  const WaitEvent& wait_event_ref() const { return *m_wait_event_ptr; }
+
+  void fingerprint(Fingerprint& fingerprint) const;
+};
+
+/// \internal Block until a condition holds
+
+/// Instead of unwinding a spin loop, only the successful evaluation of the
+/// condition is recorded. The condition's read events precede the await
+/// event in the thread, and the condition must hold whenever the await
+/// event occurs. Await events are never linked up with other events.
+class AwaitEvent : public SyncEvent {
+private:
+  // never null
+  const std::shared_ptr<ReadInstr<bool>> m_await_condition_ptr;
+
+public:
+  AwaitEvent(ThreadId thread_id,
+    const std::shared_ptr<ReadInstr<bool>>& await_condition_ptr,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
+    SyncEvent(thread_id, Zone::bottom(), true, condition_ptr),
+    m_await_condition_ptr(await_condition_ptr) {
+
+    assert(nullptr != await_condition_ptr);
+  }
+
+  /// Condition that unblocks the thread
+  const ReadInstr<bool>& await_condition_ref() const {
+    return *m_await_condition_ptr;
+  }
+
+  void fingerprint(Fingerprint& fingerprint) const;
 };
 
 }
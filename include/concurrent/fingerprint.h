@@ -0,0 +1,179 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_CONCURRENT_FINGERPRINT_H_
+#define LIBSE_CONCURRENT_FINGERPRINT_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+
+#include "concurrent/event.h"
+
+namespace se {
+
+/// \internal Structural description of a thread's events modulo identifiers
+
+/// Two threads have the same fingerprint if and only if they record the
+/// same events in the same order, up to a renaming of the thread's own
+/// event identifiers. Identifiers of events that are written by another
+/// thread (e.g. a thread-local variable that was initialized by the parent
+/// thread) are never renamed, and neither are zones.
+///
+/// A default-constructed fingerprint renames no identifiers at all. Since
+/// Threads::reset() restarts the numbering of events and zones, fingerprints
+/// of the same program agree across runs of the same build. The words of a
+/// fingerprint never depend on hash functions of the standard library, but
+/// only on mangled type names and on the object representation of literals.
+class Fingerprint {
+public:
+  typedef std::unordered_map<EventId, ThreadId> WriteEventThreadIds;
+
+private:
+  static const WriteEventThreadIds& no_write_event_thread_ids() {
+    static const WriteEventThreadIds s_write_event_thread_ids;
+    return s_write_event_thread_ids;
+  }
+
+  const bool m_is_renaming;
+  const ThreadId m_thread_id;
+
+  // threads of all write events, keyed by their identifiers
+  const WriteEventThreadIds& m_write_event_thread_ids;
+
+  std::unordered_map<EventId, size_t> m_event_id_renaming;
+  std::vector<size_t> m_words;
+
+public:
+  Fingerprint() :
+    m_is_renaming(false),
+    m_thread_id(0),
+    m_write_event_thread_ids(no_write_event_thread_ids()),
+    m_event_id_renaming(),
+    m_words() {}
+
+  Fingerprint(ThreadId thread_id,
+    const WriteEventThreadIds& write_event_thread_ids) :
+    m_is_renaming(true),
+    m_thread_id(thread_id),
+    m_write_event_thread_ids(write_event_thread_ids),
+    m_event_id_renaming(),
+    m_words() {}
+
+  /// 64-bit FNV-1a hash of the bytes, continuing from the given hash
+  static uint64_t fnv1a(const void* bytes, size_t size,
+    uint64_t hash = 0xcbf29ce484222325ULL) {
+
+    const unsigned char* const chars = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < size; i++) {
+      hash ^= chars[i];
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  void append(size_t word) { m_words.push_back(word); }
+
+  /// Append the dynamic type of the object, e.g. an event or instruction
+
+  /// Unlike std::type_info::hash_code(), the hash of the mangled type name
+  /// does not change from one run of the program to the next.
+  template<typename T>
+  void append_kind(const T& object) {
+    const char* const name = typeid(object).name();
+    append(fnv1a(name, std::strlen(name)));
+  }
+
+  template<typename T>
+  void append_literal(const T& literal) {
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= sizeof(size_t),
+      "literal must fit into a word");
+
+    size_t word = 0;
+    std::memcpy(&word, &literal, sizeof(T));
+    append(word);
+  }
+
+  /// Append another fingerprint such that it can be told apart from the rest
+  void append(const Fingerprint& other) {
+    append(other.m_words.size());
+    m_words.insert(m_words.end(), other.m_words.cbegin(), other.m_words.cend());
+  }
+
+  /// Forget all words and renamed identifiers
+  void clear() {
+    m_event_id_renaming.clear();
+    m_words.clear();
+  }
+
+  const std::vector<size_t>& words() const {
+    return m_words;
+  }
+
+  void append(const Zone& zone) {
+    append(zone.m_atoms.size());
+    for (unsigned atom : zone.m_atoms) {
+      append(atom);
+    }
+  }
+
+  /// Are event identifiers renamed relative to a thread?
+  bool is_renaming() const {
+    return m_is_renaming;
+  }
+
+  void append_event_id(EventId event_id) {
+    if (!m_is_renaming) {
+      append(0);
+      append(event_id);
+      return;
+    }
+
+    const WriteEventThreadIds::const_iterator iter =
+      m_write_event_thread_ids.find(event_id);
+    if (iter != m_write_event_thread_ids.cend() && iter->second != m_thread_id) {
+      append(0);
+      append(event_id);
+      return;
+    }
+
+    // identifiers of the thread's own events are numbered consecutively
+    const size_t renamed_event_id = m_event_id_renaming.insert(std::make_pair(
+      event_id, m_event_id_renaming.size())).first->second;
+
+    append(1);
+    append(renamed_event_id);
+  }
+
+  size_t hash() const {
+    size_t seed = m_words.size();
+    for (size_t word : m_words) {
+      seed ^= word + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+
+  bool operator==(const Fingerprint& other) const {
+    return m_words == other.m_words;
+  }
+};
+
+template<typename T>
+void WriteEvent<T>::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  instr_ref().fingerprint(fingerprint);
+}
+
+template<typename T, typename U, size_t N>
+void IndirectWriteEvent<T, U, N>::fingerprint(Fingerprint& fingerprint) const {
+  WriteEvent<T>::fingerprint(fingerprint);
+  deref_instr_ref().fingerprint(fingerprint);
+}
+
+}
+
+#endif
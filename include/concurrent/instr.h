@@ -5,6 +5,9 @@
 #ifndef LIBSE_CONCURRENT_INSTR_H_
 #define LIBSE_CONCURRENT_INSTR_H_
 
+#include <map>
+#include <array>
+#include <vector>
 #include <memory>
 #include <cassert>
 #include <utility>
@@ -13,12 +16,13 @@
 #include "core/type.h"
 
 #include "concurrent/event.h"
+#include "concurrent/fingerprint.h"
 
 #include <smt>
 
 namespace se {
 
-class Encoders;
+class TermFactory;
 class ReadInstrEncoder;
 
 /// Non-copyable class that identifies a built-in memory read instruction
@@ -43,13 +47,16 @@ public:
   virtual ~ReadInstr() {}
 
   virtual void filter(std::forward_list<std::shared_ptr<Event>>&) const = 0;
-  virtual smt::UnsafeTerm encode(const ReadInstrEncoder& encoder, Encoders& helper) const = 0;
+  virtual smt::UnsafeTerm encode(const ReadInstrEncoder& encoder, TermFactory& helper) const = 0;
+
+  /// Append the instruction's structure modulo event identifiers
+  virtual void fingerprint(Fingerprint&) const = 0;
 
   virtual std::shared_ptr<ReadInstr<bool>> condition_ptr() const = 0;
 };
 
 #define READ_ENCODER_FN_DECL \
-  smt::UnsafeTerm encode(const ReadInstrEncoder& encoder, Encoders& helper) const;
+  smt::UnsafeTerm encode(const ReadInstrEncoder& encoder, TermFactory& helper) const;
 
 template<typename T>
 class LiteralReadInstr : public ReadInstr<T> {
@@ -79,16 +86,56 @@ public:
 
   void filter(std::forward_list<std::shared_ptr<Event>>&) const { /* skip */ }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    fingerprint.append_literal(m_literal);
+  }
+
   READ_ENCODER_FN_DECL
 };
 
-/// Array filled with identical literals
+/// Array filled with literals
+
+/// Every array element is initialized to element_literal() unless the
+/// element's index is in element_stores(). If element_stores() is empty,
+/// the array is said to be "uniform".
 template<typename T, size_t N>
 class LiteralReadInstr<T[N]> : public ReadInstr<T[N]> {
+public:
+  typedef std::forward_list<std::pair<size_t, T>> ElementStores;
+
 private:
   const T m_element_literal;
+  const ElementStores m_element_stores;
   const std::shared_ptr<ReadInstr<bool>> m_condition;
 
+  // Most frequent literal in the given array
+  static T most_frequent_literal(const std::array<T, N>& literals) {
+    std::map<T, size_t> counts;
+    T result = literals.front();
+    size_t max_count = 0;
+    for (const T& literal : literals) {
+      const size_t count = ++counts[literal];
+      if (max_count < count) {
+        max_count = count;
+        result = literal;
+      }
+    }
+    return result;
+  }
+
+  static ElementStores make_element_stores(const T& element_literal,
+    const std::array<T, N>& literals) {
+
+    ElementStores stores;
+    for (size_t i = N; 0 < i; i--) {
+      if (literals[i - 1] != element_literal) {
+        stores.emplace_front(i - 1, literals[i - 1]);
+      }
+    }
+    return stores;
+  }
+
 protected:
   std::shared_ptr<ReadInstr<bool>> condition_ptr() const {
     return m_condition;
@@ -97,7 +144,20 @@ protected:
 public:
   /// Initializes every array element to zero
   LiteralReadInstr(const std::shared_ptr<ReadInstr<bool>>& condition = nullptr) :
-    m_element_literal(0), m_condition(condition) {}
+    m_element_literal(0), m_element_stores(), m_condition(condition) {}
+
+  /// Initializes every array element to the same literal
+  LiteralReadInstr(const T& element_literal,
+    const std::shared_ptr<ReadInstr<bool>>& condition = nullptr) :
+    m_element_literal(element_literal), m_element_stores(),
+    m_condition(condition) {}
+
+  /// Initializes the i-th array element to the i-th literal
+  LiteralReadInstr(const std::array<T, N>& literals,
+    const std::shared_ptr<ReadInstr<bool>>& condition = nullptr) :
+    m_element_literal(most_frequent_literal(literals)),
+    m_element_stores(make_element_stores(m_element_literal, literals)),
+    m_condition(condition) {}
 
   LiteralReadInstr(const LiteralReadInstr& other) = delete;
 
@@ -105,8 +165,22 @@ public:
 
   const T element_literal() const { return m_element_literal; }
 
+  /// Array elements whose literal differs from element_literal()
+
+  /// Each element is given by its index and literal in ascending index order.
+  const ElementStores& element_stores() const { return m_element_stores; }
+
   void filter(std::forward_list<std::shared_ptr<Event>>&) const { /* skip */ }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    fingerprint.append_literal(m_element_literal);
+    for (const std::pair<size_t, T>& element_store : m_element_stores) {
+      fingerprint.append(element_store.first);
+      fingerprint.append_literal(element_store.second);
+    }
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -139,6 +213,11 @@ public:
     event_ptrs.push_front(m_event_ptr);
   }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    fingerprint.append_event_id(m_event_ptr->event_id());
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -170,6 +249,11 @@ public:
     operand_ref().filter(event_ptrs);
   }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    operand_ref().fingerprint(fingerprint);
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -207,6 +291,12 @@ public:
     loperand_ref().filter(event_ptrs);
   }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    loperand_ref().fingerprint(fingerprint);
+    roperand_ref().fingerprint(fingerprint);
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -264,6 +354,14 @@ public:
     }
   }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    fingerprint.append(m_size);
+    for (const std::shared_ptr<ReadInstr<T>>& instr_ptr : m_operand_ptrs) {
+      instr_ptr->fingerprint(fingerprint);
+    }
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -295,6 +393,65 @@ public:
     offset_ref().filter(event_ptrs);
   }
 
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    memory_ref().fingerprint(fingerprint);
+    offset_ref().fingerprint(fingerprint);
+  }
+
+  READ_ENCODER_FN_DECL
+};
+
+/// Array of type `T` put together from elements of other arrays
+template<typename T> class ElementsReadInstr;
+
+/// The i-th element is the i-th element of the i-th array operand
+
+/// A shared array element at a literal index has its own zone, so an array
+/// operand that has been read in that zone is only up-to-date at this very
+/// element. An access of the entire array therefore reads each element in
+/// its zone and puts the elements together.
+template<typename T, size_t N>
+class ElementsReadInstr<T[N]> : public ReadInstr<T[N]> {
+public:
+  typedef std::vector<std::unique_ptr<ReadInstr<T[N]>>> OperandPtrs;
+
+private:
+  // N operands, none of them null
+  const OperandPtrs m_operand_ptrs;
+
+protected:
+  std::shared_ptr<ReadInstr<bool>> condition_ptr() const {
+    return m_operand_ptrs.front()->condition_ptr();
+  }
+
+public:
+  /// \pre: There are N operands
+  ElementsReadInstr(OperandPtrs&& operand_ptrs) :
+    m_operand_ptrs(std::move(operand_ptrs)) {
+
+    assert(m_operand_ptrs.size() == N);
+  }
+
+  ElementsReadInstr(const ElementsReadInstr& other) = delete;
+
+  ~ElementsReadInstr() {}
+
+  const OperandPtrs& operand_ptrs() const { return m_operand_ptrs; }
+
+  void filter(std::forward_list<std::shared_ptr<Event>>& event_ptrs) const {
+    for (const std::unique_ptr<ReadInstr<T[N]>>& operand_ptr : m_operand_ptrs) {
+      operand_ptr->filter(event_ptrs);
+    }
+  }
+
+  void fingerprint(Fingerprint& fingerprint) const {
+    fingerprint.append_kind(*this);
+    for (const std::unique_ptr<ReadInstr<T[N]>>& operand_ptr : m_operand_ptrs) {
+      operand_ptr->fingerprint(fingerprint);
+    }
+  }
+
   READ_ENCODER_FN_DECL
 };
 
@@ -323,9 +480,27 @@ struct ReadInstrResult<DerefReadInstr<T[N], U>> { typedef T Type; };
 class Bools {
 public:
   Bools() = delete;
+
+  /// Literal if the condition is statically known
+
+  /// \returns nullptr if the condition is not a Boolean literal
+  static const LiteralReadInstr<bool>* literal_ptr(
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr) {
+
+    return dynamic_cast<const LiteralReadInstr<bool>*>(condition_ptr.get());
+  }
+
+  /// Logical negation, folded if the condition is a Boolean literal
   static std::unique_ptr<ReadInstr<bool>> negate(
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr) {
 
+    const LiteralReadInstr<bool>* const condition_literal_ptr =
+      literal_ptr(condition_ptr);
+    if (condition_literal_ptr) {
+      return std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(
+        !condition_literal_ptr->literal(), condition_ptr->condition_ptr()));
+    }
+
     return std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(
       condition_ptr));
   }
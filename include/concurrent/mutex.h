@@ -5,42 +5,61 @@
 #ifndef LIBSE_MUTEX_H_
 #define LIBSE_MUTEX_H_
 
+#include <unordered_map>
+
 #include "concurrent.h"
 
 using namespace se::ops;
 
 namespace se {
 
-/// Symbolic spinlock
+/// Symbolic mutex
 
-/// The Mutex class symbolically encodes a spinlock that protects shared data
-/// from being simultaneously accessed by multiple threads.
+/// The Mutex class protects shared data from being simultaneously accessed
+/// by multiple threads. Every pair of lock() and unlock() calls records a
+/// critical section. The order encoder directly constrains critical sections
+/// of the same mutex not to overlap. Unlike shared variables, a mutex never
+/// adds events that need to be linked up with memory accesses.
 class Mutex {
 private:
-  unsigned m_lock_thread_id;
-  SharedVar<unsigned> m_thread_id;
+  // unique atom that identifies the mutex
+  const Zone m_zone;
 
-protected:
-  void unlock(Encoders& encoders) {
-    assert(m_lock_thread_id == ThisThread::thread_id());
-    Threads::expect(m_thread_id == m_lock_thread_id, encoders);
-  }
+  // Per-thread lock event of the critical section that is being recorded;
+  // a thread can be spawned while its parent thread holds the lock.
+  std::unordered_map<ThreadId, std::shared_ptr<LockEvent>> m_lock_event_ptrs;
 
 public:
-  Mutex() : m_lock_thread_id(0), m_thread_id() {}
+  Mutex() : m_zone(Zone::unique_atom()), m_lock_event_ptrs() {}
 
   /// Acquire lock
 
-  // TODO: Ensure recorder preserves PO between lock() and unlock()
+  /// \pre: ThisThread does not already hold the lock
   void lock() {
-    m_lock_thread_id = ThisThread::thread_id();
-    m_thread_id = m_lock_thread_id;
+    const ThreadId thread_id = ThisThread::thread_id();
+    assert(m_lock_event_ptrs.find(thread_id) == m_lock_event_ptrs.cend());
+
+    const std::shared_ptr<LockEvent> lock_event_ptr(new LockEvent(thread_id,
+      m_zone, ThisThread::path_condition_ptr()));
+    Threads::slice_append(thread_id, lock_event_ptr);
+
+    m_lock_event_ptrs.insert(std::make_pair(thread_id, lock_event_ptr));
   }
 
   /// Release lock
 
   /// \pre: ThisThread is the same as the one that called lock()
-  void unlock() { unlock(Thread::encoders()); }
+  void unlock() {
+    const ThreadId thread_id = ThisThread::thread_id();
+    assert(m_lock_event_ptrs.find(thread_id) != m_lock_event_ptrs.cend());
+
+    const std::shared_ptr<UnlockEvent> unlock_event_ptr(new UnlockEvent(
+      thread_id, m_lock_event_ptrs.at(thread_id),
+      ThisThread::path_condition_ptr()));
+    Threads::slice_append(thread_id, unlock_event_ptr);
+
+    m_lock_event_ptrs.erase(thread_id);
+  }
 };
 
 }
@@ -0,0 +1,188 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_CONCURRENT_PIPELINE_H_
+#define LIBSE_CONCURRENT_PIPELINE_H_
+
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+
+#include "concurrent/encoder.h"
+#include "concurrent/slicer.h"
+
+namespace se {
+
+/// Bounded first-in first-out queue of encoded slices
+
+/// Every element owns the Encoders into which exactly one slice has been
+/// encoded. The queue decouples the recording of slices from solving them.
+class SliceQueue {
+public:
+  typedef std::unique_ptr<Encoders> EncodersPtr;
+
+private:
+  const size_t m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+  std::deque<EncodersPtr> m_encoders_ptrs;
+  bool m_is_closed;
+
+public:
+  /// Queue that holds at most `capacity` slices, which must be positive
+  SliceQueue(size_t capacity) :
+    m_capacity(capacity),
+    m_mutex(),
+    m_not_empty(),
+    m_not_full(),
+    m_encoders_ptrs(),
+    m_is_closed(false) {
+
+    assert(0 < m_capacity);
+  }
+
+  /// Append a slice, blocking while the queue is full
+
+  /// \returns false if and only if the queue was closed, in which case
+  ///          the slice is discarded
+  bool push(EncodersPtr&& encoders_ptr) {
+    assert(nullptr != encoders_ptr);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this] {
+      return m_is_closed || m_encoders_ptrs.size() < m_capacity; });
+
+    if (m_is_closed) {
+      return false;
+    }
+
+    m_encoders_ptrs.push_back(std::move(encoders_ptr));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  /// Remove the oldest slice, blocking while the queue is empty and open
+
+  /// Slices that were pushed before the queue was closed are still returned.
+  ///
+  /// \returns nullptr if and only if the queue is closed and empty
+  EncodersPtr pop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this] {
+      return m_is_closed || !m_encoders_ptrs.empty(); });
+
+    if (m_encoders_ptrs.empty()) {
+      return nullptr;
+    }
+
+    EncodersPtr encoders_ptr(std::move(m_encoders_ptrs.front()));
+    m_encoders_ptrs.pop_front();
+    m_not_full.notify_one();
+    return encoders_ptr;
+  }
+
+  /// Reject any further slices and wake up all blocked callers
+  void close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+};
+
+/// \internal Stops the solving stage of pipelined_check() on every exit path
+
+/// The queue is closed before the thread is joined, so the solving stage
+/// cannot block forever, and a joinable thread is never destroyed, which
+/// would call std::terminate(), even if the program throws an exception.
+class SolvingStageGuard {
+private:
+  SliceQueue& m_queue;
+  std::thread& m_solving_stage;
+
+public:
+  SolvingStageGuard(SliceQueue& queue, std::thread& solving_stage) :
+    m_queue(queue),
+    m_solving_stage(solving_stage) {}
+
+  SolvingStageGuard(const SolvingStageGuard&) = delete;
+
+  ~SolvingStageGuard() {
+    m_queue.close();
+    if (m_solving_stage.joinable()) {
+      m_solving_stage.join();
+    }
+  }
+};
+
+/// Check every slice in a two-stage pipeline
+
+/// The calling thread records and encodes the next slice while another
+/// thread solves the slices that have been queued before it. At most
+/// `capacity` encoded slices wait for the solver at any time.
+///
+/// The program must have the signature `bool program(Encoders&)`. Each call
+/// must record the slice that is chosen by the given Slicer and encode it
+/// into its argument, e.g. with Threads::end_main_thread(Encoders&), and
+/// return whether there is at least one error condition to check. Since
+/// every slice is encoded into its own Encoders, each of which owns its
+/// own solver and thus its own Z3 context, the two stages never share a
+/// context; only the calling thread touches the global Threads state.
+/// Therefore, the program must not encode into any other Encoders, such
+/// as the global one of Thread::encoders(). If the program throws, the
+/// solving stage is stopped and the exception propagates to the caller.
+///
+/// \returns sat as soon as some slice has a satisfiable error condition,
+///          unknown if no slice is sat but the solver gave up on some slice,
+///          and unsat otherwise
+template<typename Program>
+smt::CheckResult pipelined_check(Slicer& slicer, Program program,
+  size_t capacity = 1) {
+
+  SliceQueue queue(capacity);
+
+  // only written by the solving stage, read after it has been joined
+  smt::CheckResult result = smt::unsat;
+
+  std::thread solving_stage([&queue, &result] {
+    SliceQueue::EncodersPtr encoders_ptr;
+    while ((encoders_ptr = queue.pop())) {
+      switch (encoders_ptr->solver.check()) {
+      case smt::sat:
+        result = smt::sat;
+        queue.close();
+        return;
+      case smt::unknown:
+        result = smt::unknown;
+        break;
+      default:
+        break;
+      }
+    }
+  });
+
+  {
+    const SolvingStageGuard guard(queue, solving_stage);
+    do {
+      SliceQueue::EncodersPtr encoders_ptr(new Encoders());
+      if (!program(*encoders_ptr)) {
+        continue;
+      }
+
+      // closed by the solving stage as soon as there is a counterexample
+      if (!queue.push(std::move(encoders_ptr))) {
+        break;
+      }
+    } while (slicer.next_slice());
+  }
+
+  return result;
+}
+
+}
+
+#endif
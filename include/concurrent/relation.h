@@ -5,6 +5,8 @@
 #ifndef LIBSE_CONCURRENT_RELATION_H_
 #define LIBSE_CONCURRENT_RELATION_H_
 
+#include <set>
+#include <vector>
 #include <unordered_set>
 #include <unordered_map>
 #include <type_traits>
@@ -53,6 +55,20 @@ public:
   static const WriteEventPredicate& predicate() { return s_write_predicate; }
 };
 
+class AnyEventPredicate : public Predicate<std::shared_ptr<Event>> {
+private:
+  static AnyEventPredicate s_any_predicate;
+
+  AnyEventPredicate() {}
+
+public:
+  virtual bool check(const std::shared_ptr<Event>& event_ptr) const {
+    return true;
+  }
+
+  static const AnyEventPredicate& predicate() { return s_any_predicate; }
+};
+
 template<class T, class U, class THash = std::hash<T>, class UHash = std::hash<U>>
 class Relation {
 private:
@@ -154,14 +170,21 @@ private:
   Relation<unsigned, std::shared_ptr<T>> m_relation;
   ZoneAtomSet m_zone_atoms;
 
+  // cache of zone_atoms(), which is stale if an event has been related since
+  mutable ZoneAtomSet m_distinct_zone_atoms;
+  mutable bool m_is_distinct_zone_atoms_stale;
+
 public:
-  ZoneRelation() : m_event_ptrs(), m_relation(), m_zone_atoms() {}
+  ZoneRelation() : m_event_ptrs(), m_relation(), m_zone_atoms(),
+    m_distinct_zone_atoms(), m_is_distinct_zone_atoms_stale(false) {}
 
   /// Clears contents
   void clear() {
     m_event_ptrs.clear();
     m_zone_atoms.clear();
     m_relation.clear();
+    m_distinct_zone_atoms.clear();
+    m_is_distinct_zone_atoms_stale = false;
   }
 
   /// All those events that were passed to relate(const std::shared_ptr<T>&)
@@ -169,12 +192,47 @@ public:
     return m_event_ptrs;
   }
 
-  const ZoneAtomSet zone_atoms() const { return m_zone_atoms; }
+  /// Atoms that relate pairwise different sets of events
+
+  /// Per-atom axioms only depend on the events that an atom relates. Atoms
+  /// that relate exactly the same events, such as the element atoms of an
+  /// array that is only accessed through symbolic indexes, are therefore
+  /// interchangeable and only one of them is returned.
+  ///
+  /// The atoms are computed once and then cached until the next call of
+  /// relate(const std::shared_ptr<T>&) or clear(). Thus, the relation must
+  /// not be shared between threads that call this member function.
+  const ZoneAtomSet& zone_atoms() const {
+    if (!m_is_distinct_zone_atoms_stale) {
+      return m_distinct_zone_atoms;
+    }
+
+    std::set<std::set<T*>> event_sets;
+    m_distinct_zone_atoms.clear();
+    for (const ZoneAtom& zone_atom : m_zone_atoms) {
+      std::unordered_set<std::shared_ptr<T>> atom_event_ptrs;
+      m_relation.find(zone_atom, AnyEventPredicate::predicate(),
+        atom_event_ptrs);
+
+      std::set<T*> event_set;
+      for (const std::shared_ptr<T>& event_ptr : atom_event_ptrs) {
+        event_set.insert(event_ptr.get());
+      }
+
+      if (event_sets.insert(std::move(event_set)).second) {
+        m_distinct_zone_atoms.insert(zone_atom);
+      }
+    }
+
+    m_is_distinct_zone_atoms_stale = false;
+    return m_distinct_zone_atoms;
+  }
 
   void relate(const std::shared_ptr<T>& event_ptr) {
     assert(!event_ptr->zone().is_bottom());
 
     m_event_ptrs.insert(event_ptr);
+    m_is_distinct_zone_atoms_stale = true;
 
     for (unsigned atom : event_ptr->zone().atoms()) {
       m_zone_atoms.insert(ZoneAtom(atom));
@@ -206,6 +264,49 @@ public:
 
     return result;
   }
+
+  /// Splits the events into the smallest relations that are closed under meets
+
+  /// Any two events whose zones meet, directly or through other events, are
+  /// in the same component. Per-zone axioms and the read-from axioms can
+  /// therefore be encoded independently for each component.
+  std::vector<ZoneRelation<T>> components() const {
+    // union-find forest over atoms, each tree is a component
+    std::unordered_map<unsigned, unsigned> parent_atoms;
+    for (const ZoneAtom& zone_atom : m_zone_atoms) {
+      const unsigned atom = zone_atom;
+      parent_atoms.insert(std::make_pair(atom, atom));
+    }
+
+    const auto root_atom = [&parent_atoms](unsigned atom) {
+      while (parent_atoms.at(atom) != atom) {
+        atom = parent_atoms.at(atom);
+      }
+      return atom;
+    };
+
+    for (const std::shared_ptr<T>& event_ptr : m_event_ptrs) {
+      const std::set<unsigned>& atoms = event_ptr->zone().atoms();
+      const unsigned root = root_atom(*atoms.cbegin());
+      for (unsigned atom : atoms) {
+        parent_atoms.at(root_atom(atom)) = root;
+      }
+    }
+
+    std::unordered_map<unsigned, size_t> component_indexes;
+    std::vector<ZoneRelation<T>> components;
+    for (const std::shared_ptr<T>& event_ptr : m_event_ptrs) {
+      const unsigned root = root_atom(*event_ptr->zone().atoms().cbegin());
+      const size_t index = component_indexes.insert(
+        std::make_pair(root, components.size())).first->second;
+      if (index == components.size()) {
+        components.emplace_back();
+      }
+      components[index].relate(event_ptr);
+    }
+
+    return components;
+  }
 };
 
 }
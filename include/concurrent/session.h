@@ -0,0 +1,101 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_CONCURRENT_SESSION_H_
+#define LIBSE_CONCURRENT_SESSION_H_
+
+#include "concurrent/event.h"
+#include "concurrent/zone.h"
+#include "concurrent/encoder.h"
+#include "concurrent/thread.h"
+
+namespace se {
+
+/// State of one verification, e.g. the recorded threads and their Encoders
+
+/// All of libse's recording functions, such as those of ThisThread, Threads
+/// and SharedVar, implicitly operate on the current session of the calling
+/// (operating system) thread. Unless a session has been bound to it with a
+/// Session::Binding, this is the default session, which is shared by all
+/// threads that have no binding. Independent sessions bound to different
+/// threads can therefore record and check programs concurrently, whereas
+/// a single session must never be used by two threads at the same time.
+///
+/// A session keeps its Encoders between checks so that their solver can be
+/// reused after Encoders::reset().
+class Session {
+private:
+  friend class Event;
+  friend class Zone;
+  friend class Thread;
+  friend class Threads;
+
+  static thread_local Session* s_current_session_ptr;
+
+  unsigned m_next_event_id;
+  unsigned m_next_zone_atom;
+  ThreadId m_next_thread_id;
+  Threads m_threads;
+  Encoders m_encoders;
+
+public:
+  /// A new session has already begun to record its main thread
+  Session() :
+    m_next_event_id(0),
+    m_next_zone_atom(0),
+    m_next_thread_id(0),
+    m_threads(),
+    m_encoders() {
+
+    Binding binding(*this);
+    Threads::reset();
+    Threads::begin_main_thread();
+  }
+
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  /// Session used by threads that are not bound to any other session
+  static Session& default_session();
+
+  /// Session that is bound to the calling thread, or the default session
+  static Session& current() {
+    if (s_current_session_ptr == nullptr) {
+      return default_session();
+    }
+
+    return *s_current_session_ptr;
+  }
+
+  Encoders& encoders() {
+    return m_encoders;
+  }
+
+  /// Binds a session to the calling thread for as long as the object lives
+
+  /// Bindings can be nested on the same thread. The destructor restores
+  /// the session that was current when the binding was created.
+  class Binding {
+  private:
+    Session* const m_previous_session_ptr;
+
+  public:
+    Binding(Session& session) :
+      m_previous_session_ptr(s_current_session_ptr) {
+
+      s_current_session_ptr = &session;
+    }
+
+    Binding(const Binding&) = delete;
+    Binding& operator=(const Binding&) = delete;
+
+    ~Binding() {
+      s_current_session_ptr = m_previous_session_ptr;
+    }
+  };
+};
+
+}
+
+#endif
@@ -49,14 +49,26 @@ constexpr LoopPolicy make_loop_policy() {
 class Loop {
 private:
   const LoopPolicy m_policy;
+  const unsigned m_unwinding_bound;
   unsigned m_unwinding_counter;
 
 public:
   constexpr Loop(const LoopPolicy& policy) :
-    m_policy(policy), m_unwinding_counter(policy.unwinding_bound()) {}
+    m_policy(policy),
+    m_unwinding_bound(policy.unwinding_bound()),
+    m_unwinding_counter(policy.unwinding_bound()) {}
+
+  /// Loop whose bound overrides the one of its policy
+
+  /// \pre 0 < unwinding_bound
+  constexpr Loop(const LoopPolicy& policy, unsigned unwinding_bound) :
+    m_policy(policy),
+    m_unwinding_bound(unwinding_bound),
+    m_unwinding_counter(unwinding_bound) {}
 
   constexpr Loop(Loop&& other) :
     m_policy(other.m_policy),
+    m_unwinding_bound(other.m_unwinding_bound),
     m_unwinding_counter(other.m_unwinding_counter) {}
 
   Loop(const Loop&) = delete;
@@ -66,7 +78,7 @@ public:
   }
 
   constexpr unsigned unwinding_bound() const {
-    return m_policy.unwinding_bound();
+    return m_unwinding_bound;
   }
 
   unsigned unwinding_counter() const {
@@ -91,6 +103,10 @@ private:
   // requires an inner loop to be fully unwound before a loop containing it.
   std::stack<Loop> m_loop_stack;
 
+  // For each branch that has not ended yet, is its condition a literal?
+  // Such a branch is statically decided and does not get any blocks.
+  std::stack<bool> m_literal_branch_stack;
+
   void set_current_block_ptr(const std::shared_ptr<Block>& block_ptr) {
     m_current_block_ptr = block_ptr;
   }
@@ -99,7 +115,8 @@ public:
   Slice() :
     m_most_outer_block_ptr(Block::make_root()),
     m_current_block_ptr(new Block(m_most_outer_block_ptr)),
-    m_loop_stack(/* empty */) {
+    m_loop_stack(/* empty */),
+    m_literal_branch_stack(/* empty */) {
 
     m_most_outer_block_ptr->push_inner_block_ptr(m_current_block_ptr);
   }
@@ -109,7 +126,8 @@ public:
   Slice(Slice&& other) :
     m_most_outer_block_ptr(std::move(other.m_most_outer_block_ptr)),
     m_current_block_ptr(std::move(other.m_current_block_ptr)),
-    m_loop_stack(std::move(other.m_loop_stack)) {}
+    m_loop_stack(std::move(other.m_loop_stack)),
+    m_literal_branch_stack(std::move(other.m_literal_branch_stack)) {}
 
   /// Append event to the current block's event list
   void append(const std::shared_ptr<Event>& event_ptr) {
@@ -154,6 +172,16 @@ public:
     return m_current_block_ptr->m_body;
   }
 
+  /// How often has the innermost loop been unwound so far?
+
+  /// \pre unwind_loop() has returned true for the innermost loop
+  unsigned unwinding_iteration() const {
+    assert(!m_loop_stack.empty());
+
+    const Loop& current_loop = m_loop_stack.top();
+    return current_loop.unwinding_bound() - current_loop.unwinding_counter();
+  }
+
   /// Unwind the loop once more if the loop unwinding policy permits it
 
   /// If the return value is false, the effect of a subsequent call to
@@ -163,15 +191,33 @@ public:
   bool unwind_loop(std::shared_ptr<ReadInstr<bool>> condition_ptr,
     const LoopPolicy& policy) {
 
+    return unwind_loop(condition_ptr, policy, policy.unwinding_bound());
+  }
+
+  /// Unwind the loop once more unless it has been unwound unwinding_bound times
+
+  /// The unwinding_bound overrides the one of the loop policy. It must be
+  /// the same for each call until the loop unwinding stops. When it stops,
+  /// the reads in the given condition are appended to the most deeply
+  /// nested unwound block so that the condition can be checked afterwards,
+  /// e.g. to find out whether the loop has been fully unwound.
+  ///
+  /// \pre 0 < unwinding_bound
+  ///
+  /// \return continue loop unwinding?
+  bool unwind_loop(std::shared_ptr<ReadInstr<bool>> condition_ptr,
+    const LoopPolicy& policy, unsigned unwinding_bound) {
+
     assert(nullptr != condition_ptr);
+    assert(0 < unwinding_bound);
 
     if (m_loop_stack.empty() || m_loop_stack.top().policy_id() != policy.id()) {
-      m_loop_stack.push(Loop(policy));
+      m_loop_stack.push(Loop(policy, unwinding_bound));
     }
 
     assert(!m_loop_stack.empty());
     assert(m_loop_stack.top().policy_id() == policy.id());
-    assert(m_loop_stack.top().unwinding_bound() == policy.unwinding_bound());
+    assert(m_loop_stack.top().unwinding_bound() == unwinding_bound);
 
     Loop& current_loop = m_loop_stack.top();
     bool continue_unwinding = true;
@@ -179,6 +225,10 @@ public:
       current_loop.decrement_unwinding_counter();
       begin_then(condition_ptr);
     } else {
+      if (nullptr == Bools::literal_ptr(condition_ptr)) {
+        append_all(*condition_ptr);
+      }
+
       // close all unwound branches of the current loop
       for (unsigned k = 0; k < current_loop.unwinding_bound(); k++) {
         end_branch();
@@ -195,8 +245,21 @@ public:
   ///
   /// This member function must be called exactly once prior to calling
   /// begin_else() or end_branch().
+  ///
+  /// If the condition is a Boolean literal, no new block is created. Instead,
+  /// the events in both branches are appended to the current block. This is
+  /// only sound if the events in the infeasible branch are guarded by a false
+  /// condition, which is why Thread::begin_then() and Thread::unwind_loop()
+  /// register even a literal in the path condition of their events.
   void begin_then(std::shared_ptr<ReadInstr<bool>> condition_ptr) {
     assert(nullptr != condition_ptr);
+
+    const bool is_literal = nullptr != Bools::literal_ptr(condition_ptr);
+    m_literal_branch_stack.push(is_literal);
+    if (is_literal) {
+      return;
+    }
+
     append_all(*condition_ptr);
 
     if (m_current_block_ptr->condition_ptr()) {
@@ -233,6 +296,11 @@ public:
   /// beginning of the "else" block. Therefore, begin_else() can only be called
   /// after calling begin_then() and then only once.
   void begin_else() {
+    assert(!m_literal_branch_stack.empty());
+    if (m_literal_branch_stack.top()) {
+      return;
+    }
+
     if (!m_current_block_ptr->condition_ptr()) {
       // unconditional blocks cannot have inner blocks
       assert(m_current_block_ptr->inner_block_ptrs().empty());
@@ -262,6 +330,13 @@ public:
   /// end_branch() must always be called exactly once such that its call site is
   /// the immediate post-dominator of begin_then().
   void end_branch() {
+    assert(!m_literal_branch_stack.empty());
+    const bool is_literal = m_literal_branch_stack.top();
+    m_literal_branch_stack.pop();
+    if (is_literal) {
+      return;
+    }
+
     std::shared_ptr<Block> outer_block_ptr(
       m_current_block_ptr->outer_block_ptr());
 
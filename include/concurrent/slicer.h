@@ -6,7 +6,12 @@
 #define LIBSE_CONCURRENT_SLICER_H_
 
 #include <map>
+#include <set>
 #include <stack>
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <utility>
 
 #include "concurrent/thread.h"
 
@@ -58,26 +63,439 @@ private:
     bool flip;
   };
 
+  // Decision for a branch that has not ended yet
+  struct BranchDecision {
+    // statically decided, i.e. the condition is a literal?
+    bool is_literal;
+    // are both blocks in the same slice?
+    bool is_merged;
+    bool execute;
+    Location loc;
+    // Threads::error_count() when the branch began
+    unsigned error_count;
+  };
+
+  // Whether to execute the "then" block, keyed by a branch location
+  typedef std::map<Location, bool> Decisions;
+
+  // "then" (true) or "else" (false) block of a branch location
+  typedef std::pair<Location, bool> Side;
+
+  // Sliced branch when the current slice first reaches it
+  struct ReachedBranch {
+    Location loc;
+    bool execute;
+    // Threads::error_count() when the branch was reached
+    unsigned error_count;
+  };
+
+  typedef std::vector<ReachedBranch> ReachedBranches;
+
+  // Slice that the prioritized scheduler has yet to analyze
+  struct SliceCandidate {
+    // decisions of the reached branches, the last of which is flipped
+    ReachedBranches path;
+    // number of branches in the path, none of which may be flipped again
+    size_t bound;
+    // number of reached branches between the flipped one and error()
+    unsigned error_distance;
+    // tie breaker, the order in which candidates have been found
+    unsigned order;
+  };
+
   const unsigned m_slice_freq;
   typedef std::map<Location, Branch> BranchMap;
   BranchMap m_branch_map;
+
+  // branch locations whose blocks are never sliced
+  std::set<Location> m_merged_locs;
+
+  // see set_adaptive_split()
+  bool m_is_adaptive_split;
+  unsigned m_split_size;
+  unsigned m_prior_size;
+
+  // memory accesses of all slices recorded so far, see set_adaptive_split()
+  unsigned long m_size_sum;
+  unsigned m_measured_count;
+
+  // has check(Encoders&) been called for the current slice?
+  bool m_is_slice_checked;
+
   unsigned m_slice_count;
-  std::stack<bool> m_branch_execute_stack;
+  std::stack<BranchDecision> m_branch_decision_stack;
+  VerdictCache m_verdict_cache;
+  unsigned m_reused_verdict_count;
+
+  // sliced branches that have been reached by the current slice
+  Decisions m_reached_decisions;
+
+  // every slice that contains one of these decisions is unsat
+  std::vector<Decisions> m_unsat_cores;
+  unsigned m_pruned_slice_count;
+
+  std::chrono::steady_clock::time_point m_begin_time;
+
+  // sliced branches in the order in which the current slice reached them
+  ReachedBranches m_reached_branches;
+
+  // blocks that have been executed by some slice
+  std::set<Side> m_covered_sides;
+
+  // blocks in which error() has been called
+  std::set<Side> m_error_sides;
+
+  bool m_is_prioritized;
+  std::vector<SliceCandidate> m_slice_candidates;
+  unsigned m_candidate_count;
+
+  // only branches reached after this many can be flipped in the current slice
+  size_t m_bound;
+
+  // Verdict of a forked process and its descendants, sent to the parent
+  struct CheckpointResult {
+    smt::CheckResult verdict;
+    unsigned slice_count;
+  };
+
+  bool m_is_checkpointing;
+
+  // write end of the pipe to the parent, or -1 unless in a forked process
+  int m_result_fd;
+
+  // joined verdicts of all slices that the forked processes have analyzed
+  smt::CheckResult m_checkpoint_verdict;
+
+  // Should a branch location that is reached for the first time be sliced?
+  bool is_split() const {
+    if (m_slice_freq == 0) {
+      return false;
+    }
+
+    if (!m_is_adaptive_split) {
+      return true;
+    }
+
+    // without any measurements, only the prior is known
+    if (m_measured_count == 0) {
+      return m_split_size <= m_prior_size;
+    }
+
+    return m_split_size <= m_size_sum / m_measured_count;
+  }
+
+  bool is_pruned() const {
+    for (const Decisions& unsat_core : m_unsat_cores) {
+      bool contains_unsat_core = true;
+      for (Decisions::const_reference decision : unsat_core) {
+        if (m_branch_map.at(decision.first).execute != decision.second) {
+          contains_unsat_core = false;
+          break;
+        }
+      }
+
+      if (contains_unsat_core) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // \returns smaller if error() has been called shortly after reaching the
+  //   i-th branch, where final_error_count is Threads::error_count() at the
+  //   end of the slice
+  unsigned error_distance(size_t i, unsigned final_error_count) const {
+    const unsigned error_count = m_reached_branches[i].error_count;
+    for (size_t j = i + 1; j < m_reached_branches.size(); j++) {
+      if (error_count < m_reached_branches[j].error_count) {
+        return j - i;
+      }
+    }
+
+    if (error_count < final_error_count) {
+      return m_reached_branches.size() - i;
+    }
+
+    return std::numeric_limits<unsigned>::max();
+  }
+
+  // \returns smt::sat if either is, otherwise smt::unknown if either is
+  static smt::CheckResult join(smt::CheckResult x, smt::CheckResult y) {
+    if (x == smt::sat || y == smt::sat) {
+      return smt::sat;
+    }
+
+    if (x == smt::unknown || y == smt::unknown) {
+      return smt::unknown;
+    }
+
+    return smt::unsat;
+  }
+
+  // Is the calling thread the only one of the process? Only then is it safe
+  // to fork, since the forked process would otherwise inherit locks held by
+  // threads that it does not have. If the threads cannot be counted, e.g.
+  // because there is no /proc file system, the answer is conservatively no.
+  // Without POSIX processes, the answer is always no.
+  static bool is_single_threaded();
+
+  // sends the verdict to the parent process and terminates this one
+  void internal_exit_checkpoint(smt::CheckResult verdict);
+
+  // Snapshots the process at a branch that is sliced. The forked process
+  // records the slice that skips the "then" block while the calling process
+  // waits for it. Afterwards, the calling process resumes from the snapshot
+  // with the "then" block. If the process cannot be forked, or the forked
+  // process fails to report its verdict and exit normally, the joined
+  // verdict becomes at best smt::unknown.
+  //
+  // 
+eturns execute the "then" block?
+  bool internal_checkpoint();
+
+  // Should candidate x be analyzed before candidate y?
+  bool is_preferred(const SliceCandidate& x, const SliceCandidate& y) const {
+    const Side x_side(x.path.back().loc, x.path.back().execute);
+    const Side y_side(y.path.back().loc, y.path.back().execute);
+
+    // first, blocks that are known to call error()
+    const bool is_x_error = m_error_sides.count(x_side) != 0;
+    const bool is_y_error = m_error_sides.count(y_side) != 0;
+    if (is_x_error != is_y_error) {
+      return is_x_error;
+    }
+
+    // second, blocks that have never been executed
+    const bool is_x_covered = m_covered_sides.count(x_side) != 0;
+    const bool is_y_covered = m_covered_sides.count(y_side) != 0;
+    if (is_x_covered != is_y_covered) {
+      return is_y_covered;
+    }
+
+    // third, branches that are shortly followed by error()
+    if (x.error_distance != y.error_distance) {
+      return x.error_distance < y.error_distance;
+    }
+
+    return x.order < y.order;
+  }
+
+  // flips the next slice in the order of a binary counter
+  bool internal_next_slice() {
+    for (;;) {
+      BranchMap::reverse_iterator rev_it(m_branch_map.rbegin());
+      while (rev_it != m_branch_map.rend() && rev_it->second.flip) {
+        // as we flip higher up branches we want to revisit
+        // both directions of any lower branches
+        rev_it->second.flip = false;
+        rev_it++;
+      }
+
+      if (rev_it == m_branch_map.rend()) {
+        return false;
+      }
+
+      rev_it->second.flip = true;
+      rev_it->second.execute = !rev_it->second.execute;
+
+      if (!is_pruned()) {
+        return true;
+      }
+
+      m_pruned_slice_count++;
+    }
+  }
+
+  // Every reached branch after the bound of the current slice gives a new
+  // candidate whose path leads to the branch and then flips it. This way,
+  // each combination of decisions at reached branches is analyzed once.
+  bool internal_next_prioritized_slice() {
+    const unsigned final_error_count = Threads::error_count();
+    for (size_t i = m_bound; i < m_reached_branches.size(); i++) {
+      SliceCandidate candidate;
+      candidate.path.assign(m_reached_branches.cbegin(),
+        m_reached_branches.cbegin() + i + 1);
+      candidate.path.back().execute = !candidate.path.back().execute;
+      candidate.bound = i + 1;
+      candidate.error_distance = error_distance(i, final_error_count);
+      candidate.order = m_candidate_count++;
+      m_slice_candidates.push_back(std::move(candidate));
+    }
+
+    if (m_slice_candidates.empty()) {
+      return false;
+    }
+
+    std::vector<SliceCandidate>::iterator best_it(m_slice_candidates.begin());
+    for (std::vector<SliceCandidate>::iterator it(m_slice_candidates.begin());
+         it != m_slice_candidates.end(); it++) {
+      if (is_preferred(*it, *best_it)) {
+        best_it = it;
+      }
+    }
+
+    // branches that are first reached after the path are not executed
+    for (BranchMap::reference branch : m_branch_map) {
+      branch.second.execute = false;
+    }
+    for (const ReachedBranch& reached_branch : best_it->path) {
+      m_branch_map.at(reached_branch.loc).execute = reached_branch.execute;
+    }
+
+    m_bound = best_it->bound;
+    m_slice_candidates.erase(best_it);
+    return true;
+  }
 
 public:
   /// If the argument is zero, the series-parallel DAG is never sliced
+
+  /// Otherwise, every branch location is sliced, unless set_adaptive_split()
+  /// is enabled.
   Slicer(unsigned slice_freq = 0) :
     m_slice_freq(slice_freq),
     m_branch_map(),
+    m_merged_locs(),
+    m_is_adaptive_split(false),
+    m_split_size(0),
+    m_prior_size(0),
+    m_size_sum(0),
+    m_measured_count(0),
+    m_is_slice_checked(false),
     m_slice_count(1),
-    m_branch_execute_stack() {}
+    m_branch_decision_stack(),
+    m_verdict_cache(),
+    m_reused_verdict_count(0),
+    m_reached_decisions(),
+    m_unsat_cores(),
+    m_pruned_slice_count(0),
+    m_begin_time(std::chrono::steady_clock::now()),
+    m_reached_branches(),
+    m_covered_sides(),
+    m_error_sides(),
+    m_is_prioritized(false),
+    m_slice_candidates(),
+    m_candidate_count(0),
+    m_bound(0),
+    m_is_checkpointing(false),
+    m_result_fd(-1),
+    m_checkpoint_verdict(smt::unsat) {}
 
   /// Number of slices made
   unsigned slice_count() const {
     return m_slice_count;
   }
 
+  /// Number of slices that have been skipped because they are known to be unsat
+  unsigned pruned_slice_count() const {
+    return m_pruned_slice_count;
+  }
+
+  /// Number of slices whose verdict has been reused by check(Encoders&)
+  unsigned reused_verdict_count() const {
+    return m_reused_verdict_count;
+  }
+
+  /// Should only the branches of large slices be sliced?
+
+  /// Which branch locations are sliced is decided once, when a location is
+  /// first reached. With adaptive splitting, a location is only sliced if
+  /// the slices recorded so far have on average at least split_size memory
+  /// accesses, i.e. reads and writes of shared variables. Otherwise, both
+  /// blocks of the branch are kept in the same slice, trading more slices
+  /// for a larger formula per slice. Until next_slice() has measured the
+  /// first slice, prior_size stands in for the average.
+  ///
+  /// The size of a slice is a deterministic estimate of the effort to
+  /// encode and solve it, so the same program is always sliced alike.
+  ///
+  /// \pre next_slice() has not been called yet
+  void set_adaptive_split(unsigned split_size, unsigned prior_size) {
+    assert(m_slice_count == 1);
+    assert(m_branch_map.empty());
+
+    m_is_adaptive_split = true;
+    m_split_size = split_size;
+    m_prior_size = prior_size;
+  }
+
+  /// Should slices be analyzed in the order in which they likely expose bugs?
+
+  /// By default, the decisions of all sliced branches are enumerated like
+  /// the digits of a binary counter. If prioritization is enabled, the next
+  /// slice is instead chosen among the slices that flip a single branch of
+  /// an earlier one. This favours blocks that are known to call error(),
+  /// then blocks that no slice has executed yet, and then branches that are
+  /// closely followed by an error() call. Either way, every combination of
+  /// decisions is eventually analyzed unless a bug is found.
+  ///
+  /// \pre next_slice() has not been called yet
+  void set_prioritization(bool is_prioritized) {
+    assert(m_slice_count == 1);
+    m_is_prioritized = is_prioritized;
+  }
+
+  /// Should slices resume from a snapshot of the process at a sliced branch?
+
+  /// Normally, each slice records the program from the beginning. With
+  /// checkpointing, the process is instead forked whenever it reaches a
+  /// branch that is sliced. The forked process analyzes the slices that
+  /// skip the "then" block, and the original one resumes with the "then"
+  /// block once the forked process has sent its verdict through a pipe.
+  /// Thus, all slices are analyzed in a single iteration of the usual
+  /// `do { ... } while(slicer.next_slice())` loop, whose check(Encoders&)
+  /// returns the joined verdict of all slices, and slice_count() is the
+  /// total number of slices. Prioritization has no effect then.
+  ///
+  /// Forked processes terminate in next_slice(), or in check(Encoders&)
+  /// as soon as they find a bug. Since they never return from either
+  /// function, the loop must call next_slice() after check(Encoders&)
+  /// unless the latter returns smt::sat. A forked process only reports the
+  /// verdict of check(Encoders&), so next_slice() asserts that it has been
+  /// called for the current slice. Nothing else that a forked process does,
+  /// e.g. failing a test expectation, is seen by the original process.
+  ///
+  /// Only a process with a single thread can be forked safely. Therefore,
+  /// checkpointing cannot be enabled while other threads are running. This
+  /// is checked only once, so no other thread may be started afterwards.
+  /// In particular, checkpointing must not be combined with pipelined_check(),
+  /// whose solving stage runs while the slices are recorded. The jobs of a
+  /// parallel encoding, see Threads::set_encoding_jobs(), have terminated
+  /// before any branch is recorded. If a forked process does not exit
+  /// normally, e.g. because it crashes, check(Encoders&) returns at best
+  /// smt::unknown. Checkpointing requires POSIX processes and can never be
+  /// enabled without them.
+  ///
+  /// \pre next_slice() has not been called yet
+  ///
+  /// \returns false if and only if checkpointing should be enabled but the
+  ///   calling thread is not known to be the only one of the process, in
+  ///   which case the slices are still recorded from the beginning
+  bool set_checkpointing(bool is_checkpointing) {
+    assert(m_slice_count == 1);
+    assert(m_branch_map.empty());
+
+    if (is_checkpointing && !is_single_threaded()) {
+      m_is_checkpointing = false;
+      return false;
+    }
+
+    m_is_checkpointing = is_checkpointing;
+    return true;
+  }
+
+  /// Time since the Slicer was constructed or begin_slice_loop() was called
+
+  /// For example, once a slice exposes a bug, this is the time it took to
+  /// find the first counterexample.
+  std::chrono::microseconds elapsed_time() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_begin_time);
+  }
+
   void begin_slice_loop() {
+    m_begin_time = std::chrono::steady_clock::now();
     Threads::begin_slice_loop();
   }
 
@@ -87,26 +505,56 @@ public:
   /// This member function must be called exactly once prior to calling
   /// end_branch(Location).
   ///
+  /// If the condition is a Boolean literal, the branch is statically decided:
+  /// the return value is the literal and neither the thread's path condition
+  /// nor the slice are changed. Also, the branch is never sliced.
+  ///
   /// \returns execute the conditional block?
   bool begin_then_branch(Location loc, std::shared_ptr<ReadInstr<bool>> condition_ptr) {
     assert(nullptr != condition_ptr);
 
-    ThisThread::begin_then(condition_ptr);
-
-    if (m_slice_freq == 0) {
-      return true;
+    const LiteralReadInstr<bool>* const literal_ptr =
+      Bools::literal_ptr(condition_ptr);
+    if (literal_ptr) {
+      const BranchDecision decision = {true, false, literal_ptr->literal(),
+        loc, Threads::error_count()};
+      m_branch_decision_stack.push(decision);
+      return decision.execute;
     }
 
+    ThisThread::begin_then(condition_ptr);
+
     bool execute = false;
     const BranchMap::iterator branch_it(m_branch_map.find(loc));
     if (branch_it == m_branch_map.cend()) {
+      if (m_merged_locs.count(loc) != 0 || !is_split()) {
+        m_merged_locs.insert(loc);
+
+        const BranchDecision decision = {false, true, true,
+          loc, Threads::error_count()};
+        m_branch_decision_stack.push(decision);
+        return true;
+      }
+
+      if (m_is_checkpointing) {
+        execute = internal_checkpoint();
+      }
+
       const Branch new_branch = {execute, false};
       m_branch_map.insert(BranchMap::value_type(loc, new_branch));
     } else {
       execute = branch_it->second.execute;
     }
 
-    m_branch_execute_stack.push(execute);
+    if (m_reached_decisions.insert(Decisions::value_type(loc, execute)).second) {
+      const ReachedBranch reached_branch = {loc, execute, Threads::error_count()};
+      m_reached_branches.push_back(reached_branch);
+    }
+    m_covered_sides.insert(Side(loc, execute));
+
+    const BranchDecision decision = {false, false, execute,
+      loc, Threads::error_count()};
+    m_branch_decision_stack.push(decision);
     return execute;
   }
 
@@ -119,13 +567,23 @@ public:
   ///
   /// \return execute the optional block?
   bool begin_else_branch(Location loc) {
+    assert(!m_branch_decision_stack.empty());
+    const BranchDecision& decision = m_branch_decision_stack.top();
+    if (decision.is_literal) {
+      return !decision.execute;
+    }
+
     ThisThread::begin_else();
 
-    if (m_slice_freq == 0) {
+    if (decision.is_merged) {
       return true;
     }
 
-    return !m_branch_execute_stack.top();
+    if (decision.execute && decision.error_count < Threads::error_count()) {
+      m_error_sides.insert(Side(decision.loc, true));
+    }
+
+    return !decision.execute;
   }
 
   /// Demarcate the end of a conditional "then" and an optional "else" branch
@@ -133,38 +591,103 @@ public:
   /// end_branch() must always be called exactly once such that its call site
   /// is the immediate post-dominator of begin_then().
   void end_branch(Location loc) {
+    assert(!m_branch_decision_stack.empty());
+    const BranchDecision decision = m_branch_decision_stack.top();
+    m_branch_decision_stack.pop();
+
+    if (decision.is_literal) {
+      return;
+    }
+
     ThisThread::end_branch();
 
-    if (m_slice_freq > 0) {
-      m_branch_execute_stack.pop();
+    if (!decision.is_merged && !decision.execute &&
+        decision.error_count < Threads::error_count()) {
+      m_error_sides.insert(Side(decision.loc, false));
+    }
+  }
+
+  /// Calls end_thread() and then checks the recorded slice unless it is known
+
+  /// Flipping a branch often has no effect on the shared events, so that
+  /// several slices are recorded in exactly the same way. Only the first of
+  /// them is encoded and solved, and the others reuse its verdict if all the
+  /// words of their Threads::program_fingerprint() are equal, not just their
+  /// hashes.
+  ///
+  /// If the slice is unsat, so is every slice that makes the same decisions
+  /// at the branches that have been reached by this one, because the other
+  /// branches cannot change the recording. next_slice() skips such slices.
+  ///
+  /// \pre every slice is recorded after Threads::reset()
+  ///
+  /// \returns smt::sat if and only if an error condition is satisfiable
+  smt::CheckResult check(Encoders& encoders) {
+    const unsigned hit_count = m_verdict_cache.hit_count();
+    smt::CheckResult verdict =
+      Threads::cached_check(m_verdict_cache, encoders);
+    m_is_slice_checked = true;
+    if (hit_count < m_verdict_cache.hit_count()) {
+      m_reused_verdict_count++;
     }
+
+    if (verdict == smt::unsat) {
+      m_unsat_cores.push_back(m_reached_decisions);
+    }
+
+    if (m_is_checkpointing) {
+      verdict = join(verdict, m_checkpoint_verdict);
+      m_checkpoint_verdict = verdict;
+      if (verdict == smt::sat && m_result_fd != -1) {
+        internal_exit_checkpoint(smt::sat);
+      }
+    }
+
+    return verdict;
   }
 
   /// Look for another slice to analyze
 
+  /// Unless prioritization is enabled, slices that are known to be unsat
+  /// by check(Encoders&) are skipped. The prioritized order never leads
+  /// to such slices in the first place.
+  ///
+  /// \pre check(Encoders&) has been called for the current slice if
+  ///   checkpointing is enabled
+  ///
   /// \returns is there another slice to analyze?
   bool next_slice() {
-    if (m_branch_map.empty()) {
+    if (m_is_checkpointing) {
+      assert(m_is_slice_checked);
+
+      // every slice has been analyzed by a forked process
+      if (m_result_fd != -1) {
+        internal_exit_checkpoint(m_checkpoint_verdict);
+      }
+
       return false;
     }
 
-    BranchMap::reverse_iterator rev_it(m_branch_map.rbegin());
-    while (rev_it != m_branch_map.rend() && rev_it->second.flip) {
-      // as we flip higher up branches we want to revisit
-      // both directions of any lower branches
-      rev_it->second.flip = false;
-      rev_it++;
+    if (m_is_adaptive_split) {
+      m_size_sum += Threads::memory_event_count();
+      m_measured_count++;
     }
+    m_is_slice_checked = false;
 
-    if (rev_it == m_branch_map.rend()) {
+    if (m_branch_map.empty()) {
       return false;
     }
 
-    rev_it->second.flip = true;
-    rev_it->second.execute = !rev_it->second.execute;
+    const bool has_next_slice = m_is_prioritized ?
+      internal_next_prioritized_slice() : internal_next_slice();
 
-    m_slice_count++;
-    return true;
+    m_reached_decisions.clear();
+    m_reached_branches.clear();
+    if (has_next_slice) {
+      m_slice_count++;
+    }
+
+    return has_next_slice;
   }
 };
 
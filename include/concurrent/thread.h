@@ -5,11 +5,17 @@
 #ifndef LIBSE_CONCURRENT_THREAD_H_
 #define LIBSE_CONCURRENT_THREAD_H_
 
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <stack>
 #include <unordered_map>
 
 #include "concurrent/zone.h"
 #include "concurrent/event.h"
+#include "concurrent/fingerprint.h"
+#include "concurrent/verdict_cache.h"
 #include "concurrent/encoder_c0.h"
 #include "concurrent/slice.h"
 
@@ -41,6 +47,26 @@ namespace ThisThread {
 
   /// End conditional "then" and optional "else" branch
   void end_branch();
+
+  /// Unwind the loop once more if its bound permits it
+
+  /// Use it as in `while (ThisThread::unwind_loop(i < n, policy)) { ... }`.
+  /// The loop is unwound as often as Threads::unwinding_bound(policy).
+  ///
+  /// \return continue loop unwinding?
+  bool unwind_loop(std::shared_ptr<ReadInstr<bool>>, const LoopPolicy&);
+
+  /// Begin a section of events that no other thread can interleave with
+  void begin_atomic();
+
+  /// End the most recently started atomic section
+  void end_atomic();
+
+  /// Is the current thread inside an atomic section?
+  bool is_atomic();
+
+  /// Block until the given condition holds
+  void await(std::unique_ptr<ReadInstr<bool>>);
 }
 
 extern Encoders& global_encoders();
@@ -55,7 +81,9 @@ private:
   typedef std::forward_list<ConditionPtr> ConditionPtrs;
 
   static const std::shared_ptr<ReadInstr<bool>> s_true_condition_ptr;
-  static ThreadId s_next_thread_id;
+
+  // counter of the current Session
+  static ThreadId& next_thread_id();
 
   // unique thread identifier
   const ThreadId m_thread_id;
@@ -71,14 +99,22 @@ private:
   ConditionPtrs m_condition_ptrs;
   std::stack<ConditionPtr> m_path_condition_ptr_cache;
 
+  // number of loop unwindings that enclose the current event
+  unsigned m_unwinding_depth;
+
+  // number of atomic sections that enclose the current event
+  unsigned m_atomic_depth;
+
   // \internal called by Threads::begin_thread()
   Thread(Thread* parent_thread_ptr) :
-    m_thread_id(s_next_thread_id++),
+    m_thread_id(next_thread_id()++),
     m_parent_thread_ptr(parent_thread_ptr),
     m_send_event_ptr(nullptr),
     m_condition_ptrs_size(0),
     m_condition_ptrs(),
-    m_path_condition_ptr_cache() {}
+    m_path_condition_ptr_cache(),
+    m_unwinding_depth(0),
+    m_atomic_depth(0) {}
 
   Thread* parent_thread_ptr() const {
     return m_parent_thread_ptr;
@@ -144,7 +180,9 @@ public:
     m_parent_thread_ptr(other.m_parent_thread_ptr),
     m_send_event_ptr(std::move(other.m_send_event_ptr)),
     m_condition_ptrs_size(other.m_condition_ptrs_size),
-    m_condition_ptrs(std::move(other.m_condition_ptrs)) {}
+    m_condition_ptrs(std::move(other.m_condition_ptrs)),
+    m_unwinding_depth(other.m_unwinding_depth),
+    m_atomic_depth(other.m_atomic_depth) {}
 
   ThreadId thread_id() const {
     return m_thread_id;
@@ -153,6 +191,13 @@ public:
   void begin_then(std::shared_ptr<ReadInstr<bool>>);
   void begin_else();
   void end_branch();
+  bool unwind_loop(std::shared_ptr<ReadInstr<bool>>, const LoopPolicy&);
+  void begin_atomic();
+  void end_atomic();
+
+  bool is_atomic() const {
+    return m_atomic_depth != 0;
+  }
 
   std::shared_ptr<ReadInstr<bool>> path_condition_ptr();
 
@@ -168,18 +213,35 @@ public:
   void join() noexcept;
 };
 
-/// \internal Thread helper singleton
+/// \internal Recorded threads of the current Session
 class Threads {
 private:
-  static Threads s_singleton;
+  friend class Session;
+
+  // threads of the current Session
+  static Threads& singleton();
 
   std::stack<Thread> m_thread_stack;
 
   // nullptr if and only if this is the main thread
   Thread* m_current_thread_ptr;
 
-  // must only be accessed before Encoders solver is deallocated
-  std::forward_list<smt::UnsafeTerm> m_error_exprs;
+  // Each error condition together with the number of loop unwindings
+  // that enclose it in its thread, i.e. its unwinding depth. These must
+  // only be accessed before Encoders solver is deallocated.
+  typedef std::forward_list<std::pair<unsigned, smt::UnsafeTerm>> ErrorExprs;
+  ErrorExprs m_error_exprs;
+
+  // number of error conditions since reset(), unlike m_error_exprs never cleared
+  unsigned m_error_count;
+
+  // conditions that expect() and internal_error() have asserted since
+  // reset(), so that they can be asserted in other solvers as well
+  std::forward_list<smt::UnsafeTerm> m_assumption_exprs;
+
+  // fingerprints of the conditions given to error(), expect() and
+  // internal_error(), in the order in which they were given
+  Fingerprint m_condition_fingerprint;
 
   // per-thread series-parallel graph where each vertex is an event pointer
   typedef std::unordered_map<ThreadId, Slice> SliceMap;
@@ -188,15 +250,63 @@ private:
   ThreadId m_main_thread_id;
   std::forward_list<std::shared_ptr<Event>> m_main_init_event_ptrs;
 
+  // are threads with the same fingerprint interchangeable?
+  bool m_symmetry_reduction;
+
+  // number of threads that encode the memory accesses, at least one
+  unsigned m_encoding_jobs;
+
+  // loop unwinding bounds that override those of the loop policies,
+  // keyed by loop policy identifiers
+  typedef std::unordered_map<unsigned, unsigned> UnwindingBounds;
+  UnwindingBounds m_unwinding_bounds;
+
+  // bound of loops without an entry in m_unwinding_bounds, or zero if such
+  // loops are unwound according to their loop policies
+  unsigned m_default_unwinding_bound;
+
+  // For each unwound loop iteration, the loop policy identifier, the number
+  // of the iteration, starting from one, the condition under which the
+  // iteration is executed, including the path condition, and the block of
+  // the iteration's events. When the loop unwinding stops after n
+  // iterations, iteration n + 1 is the condition under which the loop would
+  // have to be unwound even further, which has no block. Neither has an
+  // iteration whose loop condition is a literal, see Slice::begin_then().
+  struct UnwindingCondition {
+    unsigned loop_policy_id;
+    unsigned iteration;
+    std::shared_ptr<ReadInstr<bool>> condition_ptr;
+    std::shared_ptr<Block> block_ptr;
+  };
+  typedef std::forward_list<UnwindingCondition> UnwindingConditionPtrs;
+  UnwindingConditionPtrs m_unwinding_condition_ptrs;
+
+  // is the program recorded for the inductive step of induction_check()?
+  bool m_is_inductive_step;
+
+  // has the program assigned an arbitrary value in the inductive step?
+  bool m_is_havocked;
+
   Threads() :
     m_thread_stack(),
     m_current_thread_ptr(nullptr),
     m_error_exprs(),
+    m_error_count(0),
+    m_assumption_exprs(),
+    m_condition_fingerprint(),
     m_slice_map(),
     m_main_thread_id(0),
-    m_main_init_event_ptrs() {
-
-    internal_reset(0, 0);
+    m_main_init_event_ptrs(),
+    m_symmetry_reduction(false),
+    m_encoding_jobs(1),
+    m_unwinding_bounds(),
+    m_default_unwinding_bound(0),
+    m_unwinding_condition_ptrs(),
+    m_is_inductive_step(false),
+    m_is_havocked(false) {
+
+    // unlike reset(), leaves the counters of the current Session alone
+    m_slice_map[m_main_thread_id];
   }
 
   // Clears the entire thread stack and restarts recording the main thread
@@ -210,20 +320,295 @@ private:
 
     m_current_thread_ptr = nullptr;
     assert(m_error_exprs.empty());
+    m_error_count = 0;
+    m_assumption_exprs.clear();
+    m_condition_fingerprint.clear();
 
     m_slice_map.clear();
     m_slice_map[m_main_thread_id].append_all(m_main_init_event_ptrs);
+
+    m_symmetry_reduction = false;
+    m_encoding_jobs = 1;
+    m_unwinding_bounds.clear();
+    m_default_unwinding_bound = 0;
+    m_unwinding_condition_ptrs.clear();
+    m_is_inductive_step = false;
+    m_is_havocked = false;
+  }
+
+  static void internal_write_event_thread_ids(const Block& block,
+    Fingerprint::WriteEventThreadIds& write_event_thread_ids) {
+
+    for (const std::shared_ptr<Event>& event_ptr : block.body()) {
+      if (event_ptr->is_write()) {
+        write_event_thread_ids.insert(std::make_pair(event_ptr->event_id(),
+          event_ptr->thread_id()));
+      }
+    }
+
+    for (const std::shared_ptr<Block>& inner_block_ptr : block.inner_block_ptrs()) {
+      internal_write_event_thread_ids(*inner_block_ptr, write_event_thread_ids);
+      if (inner_block_ptr->else_block_ptr()) {
+        internal_write_event_thread_ids(*inner_block_ptr->else_block_ptr(),
+          write_event_thread_ids);
+      }
+    }
+  }
+
+  // memory accesses, i.e. events that are neither local nor blocking
+  static void internal_memory_event_ptrs(const Block& block,
+    std::vector<std::shared_ptr<Event>>& memory_event_ptrs) {
+
+    for (const std::shared_ptr<Event>& event_ptr : block.body()) {
+      if (event_ptr->zone().is_bottom()) { continue; }
+      if (dynamic_cast<const BlockingEvent*>(event_ptr.get())) { continue; }
+
+      memory_event_ptrs.push_back(event_ptr);
+    }
+
+    for (const std::shared_ptr<Block>& inner_block_ptr : block.inner_block_ptrs()) {
+      internal_memory_event_ptrs(*inner_block_ptr, memory_event_ptrs);
+      if (inner_block_ptr->else_block_ptr()) {
+        internal_memory_event_ptrs(*inner_block_ptr->else_block_ptr(),
+          memory_event_ptrs);
+      }
+    }
+  }
+
+  static void internal_fingerprint(const Block& block, Fingerprint& fingerprint) {
+    for (const std::shared_ptr<Event>& event_ptr : block.body()) {
+      event_ptr->fingerprint(fingerprint);
+    }
+
+    // demarcate the body from the inner blocks
+    fingerprint.append(0);
+    for (const std::shared_ptr<Block>& inner_block_ptr : block.inner_block_ptrs()) {
+      fingerprint.append(1);
+      internal_fingerprint(*inner_block_ptr, fingerprint);
+      if (inner_block_ptr->else_block_ptr()) {
+        fingerprint.append(2);
+        internal_fingerprint(*inner_block_ptr->else_block_ptr(), fingerprint);
+      }
+    }
+    fingerprint.append(3);
+  }
+
+  // remembers the structure of a condition and the path that leads to it
+  static void internal_fingerprint_condition(bool is_error,
+    const ReadInstr<bool>& condition) {
+
+    Fingerprint fingerprint;
+    fingerprint.append(is_error);
+    condition.fingerprint(fingerprint);
+
+    const std::shared_ptr<ReadInstr<bool>> path_condition_ptr(
+      ThisThread::path_condition_ptr());
+    if (path_condition_ptr) {
+      path_condition_ptr->fingerprint(fingerprint);
+    } else {
+      fingerprint.append(0);
+    }
+
+    singleton().m_condition_fingerprint.append(fingerprint);
+  }
+
+  typedef std::vector<std::shared_ptr<ReceiveEvent>> ReceiveEventPtrs;
+
+  // Partitions child threads according to their fingerprints. Every class
+  // with at least two threads is given by the receive events that start the
+  // threads, ordered by thread identifiers.
+  static std::forward_list<ReceiveEventPtrs> internal_symmetric_threads() {
+    Fingerprint::WriteEventThreadIds write_event_thread_ids;
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      internal_write_event_thread_ids(
+        *slice_map_value.second.most_outer_block_ptr(), write_event_thread_ids);
+    }
+
+    typedef std::pair<Fingerprint, ReceiveEventPtrs> FingerprintClass;
+    std::unordered_multimap<size_t, FingerprintClass> fingerprint_classes;
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      // the body of the most outer block is always empty
+      const Block& most_outer_block = *slice_map_value.second.most_outer_block_ptr();
+      const Block& first_block = *most_outer_block.inner_block_ptrs().front();
+      if (first_block.body().empty()) { continue; }
+
+      // only child threads start with a receive event
+      const std::shared_ptr<ReceiveEvent> receive_event_ptr =
+        std::dynamic_pointer_cast<ReceiveEvent>(first_block.body().front());
+      if (!receive_event_ptr) { continue; }
+
+      Fingerprint fingerprint(slice_map_value.first, write_event_thread_ids);
+      internal_fingerprint(most_outer_block, fingerprint);
+
+      const size_t hash = fingerprint.hash();
+      typedef std::unordered_multimap<size_t, FingerprintClass>::iterator
+        FingerprintClassIter;
+      const std::pair<FingerprintClassIter, FingerprintClassIter> range =
+        fingerprint_classes.equal_range(hash);
+
+      FingerprintClassIter iter = range.first;
+      while (iter != range.second && !(iter->second.first == fingerprint)) {
+        iter++;
+      }
+
+      if (iter == range.second) {
+        iter = fingerprint_classes.insert(std::make_pair(hash,
+          std::make_pair(std::move(fingerprint), ReceiveEventPtrs())));
+      }
+
+      iter->second.second.push_back(receive_event_ptr);
+    }
+
+    std::forward_list<ReceiveEventPtrs> symmetric_threads;
+    for (std::pair<const size_t, FingerprintClass>& fingerprint_class :
+         fingerprint_classes) {
+
+      ReceiveEventPtrs& receive_event_ptrs = fingerprint_class.second.second;
+      if (receive_event_ptrs.size() < 2) { continue; }
+
+      std::sort(receive_event_ptrs.begin(), receive_event_ptrs.end(),
+        [](const std::shared_ptr<ReceiveEvent>& x,
+           const std::shared_ptr<ReceiveEvent>& y) {
+          return x->thread_id() < y->thread_id();
+        });
+      symmetric_threads.push_front(std::move(receive_event_ptrs));
+    }
+
+    return symmetric_threads;
   }
 
   // thread_ptr can be nullptr
   static void set_current_thread_ptr(Thread* thread_ptr) {
-    s_singleton.m_current_thread_ptr = thread_ptr;
+    singleton().m_current_thread_ptr = thread_ptr;
   }
 
+  // blocking events that the order encoder constrains directly
+  struct BlockingEventPtrs {
+    std::forward_list<std::shared_ptr<ReceiveEvent>> receive_event_ptrs;
+    std::forward_list<std::shared_ptr<UnlockEvent>> unlock_event_ptrs;
+    std::forward_list<std::shared_ptr<BarrierEvent>> barrier_event_ptrs;
+    std::forward_list<std::shared_ptr<NotifyEvent>> notify_event_ptrs;
+    std::forward_list<std::shared_ptr<WakeEvent>> wake_event_ptrs;
+
+    // mutexes that protect memory events, see internal_end_critical_section(),
+    // and the writes that happen before every thread creation
+    Locksets locksets;
+
+    void push_front(const std::shared_ptr<Event>& event_ptr) {
+      if (const std::shared_ptr<ReceiveEvent> receive_event_ptr =
+          std::dynamic_pointer_cast<ReceiveEvent>(event_ptr)) {
+        receive_event_ptrs.push_front(receive_event_ptr);
+      } else if (const std::shared_ptr<UnlockEvent> unlock_event_ptr =
+          std::dynamic_pointer_cast<UnlockEvent>(event_ptr)) {
+        unlock_event_ptrs.push_front(unlock_event_ptr);
+      } else if (const std::shared_ptr<BarrierEvent> barrier_event_ptr =
+          std::dynamic_pointer_cast<BarrierEvent>(event_ptr)) {
+        barrier_event_ptrs.push_front(barrier_event_ptr);
+      } else if (const std::shared_ptr<NotifyEvent> notify_event_ptr =
+          std::dynamic_pointer_cast<NotifyEvent>(event_ptr)) {
+        notify_event_ptrs.push_front(notify_event_ptr);
+      } else if (const std::shared_ptr<WakeEvent> wake_event_ptr =
+          std::dynamic_pointer_cast<WakeEvent>(event_ptr)) {
+        wake_event_ptrs.push_front(wake_event_ptr);
+      }
+    }
+  };
+
+  // memory events in each critical section that has been started but not
+  // yet ended along the series-parallel graph traversal
+  typedef std::vector<std::pair<const LockEvent*, std::vector<const Event*>>>
+    CriticalSections;
+
+  // Adds the mutex of the given unlock event to the lockset of every memory
+  // event in its critical section. If the lock and unlock event differ in
+  // their condition, such as when the mutex is acquired in only one branch,
+  // an event in between may occur without the critical section, so none of
+  // them is considered to be protected.
+  static void internal_end_critical_section(const UnlockEvent& unlock_event,
+    CriticalSections& critical_sections, Locksets& locksets) {
+
+    const LockEvent& lock_event = unlock_event.lock_event_ref();
+    const CriticalSections::iterator iter = std::find_if(
+      critical_sections.begin(), critical_sections.end(),
+      [&lock_event](const CriticalSections::value_type& critical_section) {
+        return critical_section.first == &lock_event;
+      });
+    if (iter == critical_sections.end()) {
+      return;
+    }
+
+    if (lock_event.condition_ptr() == unlock_event.condition_ptr()) {
+      for (const Event* event_ptr : iter->second) {
+        const Locksets::iterator lockset_iter = locksets.find(event_ptr);
+        if (lockset_iter == locksets.end()) {
+          locksets.emplace(event_ptr, unlock_event.zone());
+        } else {
+          Zone lockset(lockset_iter->second.join(unlock_event.zone()));
+          locksets.erase(lockset_iter);
+          locksets.emplace(event_ptr, std::move(lockset));
+        }
+      }
+    }
+
+    critical_sections.erase(iter);
+  }
+
+  // Block of a loop iteration that is beyond the current loop unwinding
+  // bounds of unwinding_check(), together with the clock after which the
+  // block starts and a fresh clock before which it ends. The latter stands
+  // in for the block in the program order of its thread until the block is
+  // encoded.
+  struct DeferredBlock {
+    std::shared_ptr<Block> block_ptr;
+    Clock begin_clock;
+    Clock end_clock;
+  };
+
+  // blocks of loop iterations that unwinding_check() encodes only once
+  // the loop unwinding bounds include them
+  struct UnwindingBlocks {
+    // loop policy identifier and iteration of every loop iteration's block
+    std::unordered_map<const Block*, std::pair<unsigned, unsigned>> iterations;
+
+    // loops without an entry are bounded by one
+    UnwindingBounds unwinding_bounds;
+
+    std::forward_list<DeferredBlock> deferred_blocks;
+
+    bool is_beyond_bounds(const Block& block) const {
+      const std::unordered_map<const Block*, std::pair<unsigned, unsigned>>::
+        const_iterator iter = iterations.find(&block);
+      if (iter == iterations.cend()) {
+        return false;
+      }
+
+      const UnwindingBounds::const_iterator bound_iter =
+        unwinding_bounds.find(iter->second.first);
+      const unsigned unwinding_bound = bound_iter == unwinding_bounds.cend() ?
+        1 : bound_iter->second;
+      return unwinding_bound < iter->second.second;
+    }
+  };
+
+  // atomic_depth is the number of atomic sections that have been started
+  // but not yet ended along the series-parallel graph traversal, and
+  // is_initializing tells whether the traversal has not yet passed any send
+  // or receive event. Since every child thread starts with a receive event,
+  // writes that are traversed while it holds are in the main thread before
+  // it creates any thread, such as the initialization of shared variables.
+  //
+  // If unwinding_blocks_ptr is not nullptr, the blocks of loop iterations
+  // beyond its bounds are deferred rather than encoded, except inside atomic
+  // sections, whose events share a clock term.
   static Clock internal_encode_spo(const std::shared_ptr<Block>& block_ptr,
     const Clock& earlier_clock,
     ZoneRelation<Event>& zone_relation,
-    Encoders& encoders) {
+    BlockingEventPtrs& blocking_event_ptrs,
+    unsigned& atomic_depth,
+    bool& is_initializing,
+    CriticalSections& critical_sections,
+    Encoders& encoders,
+    UnwindingBlocks* unwinding_blocks_ptr = nullptr) {
 
     const ValueEncoder value_encoder;
 
@@ -241,9 +626,81 @@ private:
           const smt::UnsafeTerm equality_expr(body_event.encode_eq(value_encoder, encoders));
           encoders.solver.unsafe_add(equality_expr);
         }
+
+        if (const AtomicEvent* const atomic_event_ptr =
+            dynamic_cast<const AtomicEvent*>(&body_event)) {
+
+          if (atomic_event_ptr->is_begin()) {
+            // nested atomic sections are part of the most outer one
+            if (atomic_depth++ == 0) {
+              const Clock atomic_clock(encoders.atomic_clock());
+              encoders.solver.add(body_clock.happens_before(atomic_clock));
+              body_clock = atomic_clock;
+            }
+          } else {
+            assert(0 < atomic_depth);
+            atomic_depth--;
+          }
+
+          continue;
+        }
+
+        if (const AwaitEvent* const await_event_ptr =
+            dynamic_cast<const AwaitEvent*>(&body_event)) {
+
+          const ReadInstrEncoder read_encoder;
+          smt::UnsafeTerm await_expr(await_event_ptr->await_condition_ref().
+            encode(read_encoder, encoders));
+          if (await_event_ptr->condition_ptr()) {
+            await_expr = smt::implies(await_event_ptr->condition_ptr()->
+              encode(read_encoder, encoders), await_expr);
+          }
+          encoders.solver.unsafe_add(await_expr);
+          continue;
+        }
   
-        if (!body_event.zone().is_bottom()) {
-          zone_relation.relate(body_event_ptr);
+        // blocking events are encoded separately from memory accesses
+        const bool is_blocking_event =
+          dynamic_cast<const BlockingEvent*>(&body_event) != nullptr;
+        if (is_blocking_event || !body_event.zone().is_bottom()) {
+          if (is_blocking_event) {
+            blocking_event_ptrs.push_front(body_event_ptr);
+
+            if (dynamic_cast<const SendEvent*>(&body_event) != nullptr ||
+                dynamic_cast<const ReceiveEvent*>(&body_event) != nullptr) {
+              is_initializing = false;
+            }
+
+            if (const LockEvent* const lock_event_ptr =
+                dynamic_cast<const LockEvent*>(&body_event)) {
+              critical_sections.emplace_back(lock_event_ptr,
+                std::vector<const Event*>());
+            } else if (const UnlockEvent* const unlock_event_ptr =
+                dynamic_cast<const UnlockEvent*>(&body_event)) {
+              internal_end_critical_section(*unlock_event_ptr,
+                critical_sections, blocking_event_ptrs.locksets);
+            }
+          } else {
+            zone_relation.relate(body_event_ptr);
+
+            // ordered before all other writes by the fork of every thread
+            if (is_initializing && body_event.is_write()) {
+              blocking_event_ptrs.locksets.emplace(&body_event, Zone::bottom());
+            }
+
+            for (CriticalSections::reference critical_section :
+                 critical_sections) {
+              critical_section.second.push_back(&body_event);
+            }
+          }
+
+          if (0 < atomic_depth) {
+            // all events in an atomic section share the section's clock term
+            assert(0 != body_clock.atomic_section());
+            body_clock = body_clock.atomic_successor();
+            encoders.set_atomic_clock(body_event, body_clock);
+            continue;
+          }
 
           Clock next_body_clock(encoders.clock(body_event));
           encoders.solver.add(body_clock.happens_before(next_body_clock));
@@ -257,13 +714,31 @@ private:
     for (const std::shared_ptr<Block>& inner_block_ptr :
       block_ptr->inner_block_ptrs()) {
 
+      if (nullptr != unwinding_blocks_ptr && 0 == atomic_depth &&
+          unwinding_blocks_ptr->is_beyond_bounds(*inner_block_ptr)) {
+
+        // loop iterations have no else block
+        assert(nullptr == inner_block_ptr->else_block_ptr());
+
+        const Clock end_clock(encoders.later_clock(inner_clock));
+        unwinding_blocks_ptr->deferred_blocks.push_front(
+          DeferredBlock{inner_block_ptr, inner_clock, end_clock});
+        inner_clock = end_clock;
+
+        // the deferred block might create threads
+        is_initializing = false;
+        continue;
+      }
+
       Clock then_clock(internal_encode_spo(inner_block_ptr, inner_clock,
-        zone_relation, encoders));
+        zone_relation, blocking_event_ptrs, atomic_depth, is_initializing,
+        critical_sections, encoders, unwinding_blocks_ptr));
       const std::shared_ptr<Block>& inner_else_block_ptr(
         inner_block_ptr->else_block_ptr());
       if (inner_else_block_ptr) {
         Clock else_clock(internal_encode_spo(inner_else_block_ptr,
-          inner_clock, zone_relation, encoders));
+          inner_clock, zone_relation, blocking_event_ptrs, atomic_depth,
+          is_initializing, critical_sections, encoders, unwinding_blocks_ptr));
         inner_clock = encoders.join_clocks(then_clock, else_clock);
       } else {
         inner_clock = then_clock;
@@ -273,57 +748,330 @@ private:
     return inner_clock;
   }
 
+  // encodes each thread in isolation and collects the events whose
+  // interleavings are still to be encoded, see internal_encode_spo()
+  static void internal_encode_threads(ZoneRelation<Event>& zone_relation,
+    BlockingEventPtrs& blocking_event_ptrs, Encoders& encoders,
+    UnwindingBlocks* unwinding_blocks_ptr = nullptr) {
+
+    encoders.clear_atomic_clocks();
+
+#ifdef __USE_MATRIX__
+    const Clock epoch_clock("epoch");
+#else
+    const Clock epoch_clock(smt::any<ClockSort>("epoch"));
+#endif
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      const std::shared_ptr<Block> most_outer_block_ptr =
+        slice_map_value.second.most_outer_block_ptr();
+      unsigned atomic_depth = 0;
+      bool is_initializing = true;
+      CriticalSections critical_sections;
+      internal_encode_spo(most_outer_block_ptr, epoch_clock, zone_relation,
+        blocking_event_ptrs, atomic_depth, is_initializing, critical_sections,
+        encoders, unwinding_blocks_ptr);
+    }
+  }
+
+  // encodes the deferred blocks that are no longer beyond the loop
+  // unwinding bounds, which in turn may defer blocks of later iterations
+  static void internal_encode_deferred_blocks(
+    ZoneRelation<Event>& zone_relation,
+    BlockingEventPtrs& blocking_event_ptrs,
+    UnwindingBlocks& unwinding_blocks,
+    Encoders& encoders) {
+
+    std::forward_list<DeferredBlock> deferred_blocks;
+    deferred_blocks.swap(unwinding_blocks.deferred_blocks);
+    for (const DeferredBlock& deferred_block : deferred_blocks) {
+      if (unwinding_blocks.is_beyond_bounds(*deferred_block.block_ptr)) {
+        unwinding_blocks.deferred_blocks.push_front(deferred_block);
+        continue;
+      }
+
+      // critical sections around the block are not tracked, so its
+      // memory events are treated as unprotected, see Locksets
+      unsigned atomic_depth = 0;
+      bool is_initializing = false;
+      CriticalSections critical_sections;
+      const Clock block_clock(internal_encode_spo(deferred_block.block_ptr,
+        deferred_block.begin_clock, zone_relation, blocking_event_ptrs,
+        atomic_depth, is_initializing, critical_sections, encoders,
+        &unwinding_blocks));
+      encoders.solver.add(block_clock.happens_before(deferred_block.end_clock));
+    }
+  }
+
+  // \returns disjunction of the error conditions
+  static smt::UnsafeTerm internal_error_expr() {
+    smt::UnsafeTerm some_error_expr(smt::literal<smt::Bool>(false));
+    for (const std::pair<unsigned, smt::UnsafeTerm>& error_expr :
+         singleton().m_error_exprs) {
+      some_error_expr = some_error_expr or error_expr.second;
+    }
+
+    return some_error_expr;
+  }
+
+  // asserts that at least one error condition holds
+  static bool internal_encode_errors(Encoders& encoders) {
+    bool has_error_conditions = !singleton().m_error_exprs.empty();
+    if (has_error_conditions) {
+      encoders.solver.unsafe_add(internal_error_expr());
+
+      singleton().m_error_exprs.clear();
+    }
+
+    return has_error_conditions;
+  }
+
+  // \returns disjunction of the conditions under which the given iteration
+  //   of a loop with the given policy identifier is executed
+  static smt::UnsafeTerm internal_unwinding_expr(unsigned loop_policy_id,
+    unsigned iteration, Encoders& encoders) {
+
+    const ReadInstrEncoder read_encoder;
+    smt::UnsafeTerm unwinding_expr(smt::literal<smt::Bool>(false));
+    for (const UnwindingCondition& unwinding_condition :
+         singleton().m_unwinding_condition_ptrs) {
+
+      if (loop_policy_id != unwinding_condition.loop_policy_id ||
+          iteration != unwinding_condition.iteration) { continue; }
+
+      unwinding_expr = unwinding_expr or
+        unwinding_condition.condition_ptr->encode(read_encoder, encoders);
+    }
+
+    return unwinding_expr;
+  }
+
+  // \returns conjunction that no loop is executed more often than its bound
+  //   in unwinding_bounds, where loops without an entry are bounded by one
+  static smt::UnsafeTerm internal_unwinding_bounds_expr(
+    const UnwindingBounds& unwinding_bounds, Encoders& encoders) {
+
+    const ReadInstrEncoder read_encoder;
+    smt::UnsafeTerm unwinding_bounds_expr(smt::literal<smt::Bool>(true));
+    for (const UnwindingCondition& unwinding_condition :
+         singleton().m_unwinding_condition_ptrs) {
+
+      const UnwindingBounds::const_iterator iter =
+        unwinding_bounds.find(unwinding_condition.loop_policy_id);
+      const unsigned unwinding_bound = iter == unwinding_bounds.cend() ?
+        1 : iter->second;
+      if (unwinding_condition.iteration <= unwinding_bound) { continue; }
+
+      unwinding_bounds_expr = unwinding_bounds_expr and
+        not unwinding_condition.condition_ptr->encode(read_encoder, encoders);
+    }
+
+    return unwinding_bounds_expr;
+  }
+
+  static void internal_encode_interleavings(
+    const ZoneRelation<Event>& zone_relation,
+    const BlockingEventPtrs& blocking_event_ptrs,
+    Encoders& encoders) {
+
+    const Z3OrderEncoderC0 order_encoder;
+    order_encoder.encode(zone_relation, singleton().m_encoding_jobs,
+      blocking_event_ptrs.locksets, encoders);
+    internal_encode_synchronization(blocking_event_ptrs, encoders);
+  }
+
+  // orders the blocking events, whose axioms, unlike those of the memory
+  // events, are not encoded incrementally by unwinding_check()
+  static void internal_encode_synchronization(
+    const BlockingEventPtrs& blocking_event_ptrs,
+    Encoders& encoders) {
+
+    const Z3OrderEncoderC0 order_encoder;
+    order_encoder.encode_fork_joins(blocking_event_ptrs.receive_event_ptrs,
+      encoders);
+    if (singleton().m_symmetry_reduction) {
+      order_encoder.encode_symmetric_threads(internal_symmetric_threads(),
+        encoders);
+    }
+    order_encoder.encode_mutexes(blocking_event_ptrs.unlock_event_ptrs, encoders);
+    order_encoder.encode_barriers(blocking_event_ptrs.barrier_event_ptrs,
+      encoders);
+    order_encoder.encode_condition_variables(
+      blocking_event_ptrs.notify_event_ptrs,
+      blocking_event_ptrs.wake_event_ptrs, encoders);
+  }
+
+  // First solves only the error conditions and the path conditions that
+  // lead to them, where every read can return any value. This is a subset
+  // of the full encoding, which is only added if the former is satisfiable.
+  static smt::CheckResult internal_two_phase_check(Encoders& encoders) {
+    if (!internal_encode_errors(encoders)) {
+      return smt::unsat;
+    }
+
+    if (encoders.solver.check() == smt::unsat) {
+      return smt::unsat;
+    }
+
+    ZoneRelation<Event> zone_relation;
+    BlockingEventPtrs blocking_event_ptrs;
+    internal_encode_threads(zone_relation, blocking_event_ptrs, encoders);
+    internal_encode_interleavings(zone_relation, blocking_event_ptrs, encoders);
+    return encoders.solver.check();
+  }
+
 public:
   /// \internal Modifiable reference to the current thread
 
   /// \pre: Threads::begin_thread(const Thread&) must have been called
   static Thread& current_thread() {
-    assert(s_singleton.m_current_thread_ptr != nullptr);
-    return *s_singleton.m_current_thread_ptr;
+    assert(singleton().m_current_thread_ptr != nullptr);
+    return *singleton().m_current_thread_ptr;
   }
 
   static std::shared_ptr<Block> slice_most_outer_block_ptr(ThreadId thread_id) {
-    return s_singleton.m_slice_map[thread_id].most_outer_block_ptr();
+    return singleton().m_slice_map[thread_id].most_outer_block_ptr();
   }
 
   static void slice_append(ThreadId thread_id, const EventPtr& event_ptr) {
-    s_singleton.m_slice_map[thread_id].append(event_ptr);
+    singleton().m_slice_map[thread_id].append(event_ptr);
   }
 
   /// Append all read events that are in the given instruction
   template<typename T>
   static void slice_append_all(ThreadId thread_id, const ReadInstr<T>& instr) {
-    s_singleton.m_slice_map[thread_id].append_all(instr);
+    singleton().m_slice_map[thread_id].append_all(instr);
   }
 
   /// Append all the given event pointers
   static void slice_append_all(ThreadId thread_id,
     const std::forward_list<std::shared_ptr<Event>>& event_ptrs) {
-    s_singleton.m_slice_map[thread_id].append_all(event_ptrs);
+    singleton().m_slice_map[thread_id].append_all(event_ptrs);
   }
 
   static void slice_begin_then(ThreadId thread_id,
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr) {
-    s_singleton.m_slice_map[thread_id].begin_then(condition_ptr);
+    singleton().m_slice_map[thread_id].begin_then(condition_ptr);
   }
 
   static void slice_begin_else(ThreadId thread_id) {
-    s_singleton.m_slice_map[thread_id].begin_else();
+    singleton().m_slice_map[thread_id].begin_else();
   }
 
   static void slice_end_branch(ThreadId thread_id) {
-    s_singleton.m_slice_map[thread_id].end_branch();
+    singleton().m_slice_map[thread_id].end_branch();
+  }
+
+  static bool slice_unwind_loop(ThreadId thread_id,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr,
+    const LoopPolicy& policy, unsigned unwinding_bound) {
+    return singleton().m_slice_map[thread_id].unwind_loop(condition_ptr,
+      policy, unwinding_bound);
+  }
+
+  /// How often is a loop with the given policy unwound?
+  static unsigned unwinding_bound(const LoopPolicy& policy) {
+    const UnwindingBounds::const_iterator iter =
+      singleton().m_unwinding_bounds.find(policy.id());
+    if (iter != singleton().m_unwinding_bounds.cend()) {
+      return iter->second;
+    }
+
+    if (singleton().m_default_unwinding_bound != 0) {
+      return singleton().m_default_unwinding_bound;
+    }
+
+    return policy.unwinding_bound();
+  }
+
+  /// Override the unwinding bound of loops with the given policy identifier
+
+  /// Loop unwinding bounds are erased by reset().
+  ///
+  /// \pre 0 < unwinding_bound
+  static void set_unwinding_bound(unsigned loop_policy_id,
+    unsigned unwinding_bound) {
+
+    assert(0 < unwinding_bound);
+    singleton().m_unwinding_bounds[loop_policy_id] = unwinding_bound;
+  }
+
+  static unsigned slice_unwinding_iteration(ThreadId thread_id) {
+    return singleton().m_slice_map[thread_id].unwinding_iteration();
+  }
+
+  static std::shared_ptr<Block> slice_current_block_ptr(ThreadId thread_id) {
+    return singleton().m_slice_map[thread_id].current_block_ptr();
+  }
+
+  /// \internal Record the condition of a loop iteration
+
+  /// \param iteration - number of the iteration, starting from one, or the
+  ///   unwinding bound plus one if the loop unwinding has stopped
+  /// \param condition_ptr - condition under which the iteration is executed,
+  ///   including the path condition
+  /// \param block_ptr - block of the iteration's events, or nullptr if there
+  ///   is no such block
+  static void unwind(const LoopPolicy& policy, unsigned iteration,
+    const std::shared_ptr<ReadInstr<bool>>& condition_ptr,
+    const std::shared_ptr<Block>& block_ptr = nullptr) {
+
+    singleton().m_unwinding_condition_ptrs.push_front(
+      UnwindingCondition{policy.id(), iteration, condition_ptr, block_ptr});
+  }
+
+  /// Number of times that error() has been called since reset()
+  static unsigned error_count() {
+    return singleton().m_error_count;
+  }
+
+  /// Number of memory accesses that have been recorded since reset()
+  static unsigned memory_event_count() {
+    std::vector<std::shared_ptr<Event>> memory_event_ptrs;
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      internal_memory_event_ptrs(*slice_map_value.second.most_outer_block_ptr(),
+        memory_event_ptrs);
+    }
+
+    return memory_event_ptrs.size();
   }
 
   /// Erase any previous thread recordings
   static void reset(unsigned next_event_id = 0, unsigned next_zone = 0) {
-    return s_singleton.internal_reset(next_event_id, next_zone);
+    return singleton().internal_reset(next_event_id, next_zone);
+  }
+
+  /// Should threads that record the same events be treated as interchangeable?
+
+  /// If enabled, encode(Encoders&) breaks the symmetry between child threads
+  /// whose recorded events are the same up to event identifiers, such as two
+  /// threads that run the same function with the same arguments. The clocks
+  /// of the first events of such threads are ordered by thread identifiers.
+  /// Symmetry reduction is disabled by reset().
+  ///
+  /// \warning Only sound if the error conditions are also symmetric, i.e.
+  ///          swapping two such threads does not change their outcome, and
+  ///          if interchangeable threads are spawned without any events in
+  ///          between, and are also joined in the same manner.
+  static void set_symmetry_reduction(bool symmetry_reduction) {
+    singleton().m_symmetry_reduction = symmetry_reduction;
+  }
+
+  /// How many threads should encode the memory accesses between threads?
+
+  /// Accesses to unrelated zones, e.g. different shared variables, are
+  /// encoded in parallel if there is more than one job, see
+  /// Z3OrderEncoderC0::encode(const ZoneRelation<Event>&, unsigned,
+  /// const Locksets&, Encoders&).
+  /// The number of jobs is reset to one by reset().
+  static void set_encoding_jobs(unsigned encoding_jobs) {
+    assert(0 < encoding_jobs);
+    singleton().m_encoding_jobs = encoding_jobs;
   }
 
   /// Start recording a new thread of execution
   static void begin_thread() {
-    s_singleton.m_thread_stack.push(Thread(s_singleton.m_current_thread_ptr));
-    begin_thread(&s_singleton.m_thread_stack.top());
+    singleton().m_thread_stack.push(Thread(singleton().m_current_thread_ptr));
+    begin_thread(&singleton().m_thread_stack.top());
   }
 
   /// Demarcate the start of a new child thread
@@ -336,7 +1084,7 @@ public:
       slice_append(parent_thread.thread_id(), send_event_ptr);
 
       std::unique_ptr<ReceiveEvent> receive_event_ptr(new ReceiveEvent(
-        child_thread.thread_id(), send_event_ptr->zone(),
+        child_thread.thread_id(), send_event_ptr,
         child_thread.path_condition_ptr()));
 
       slice_append(child_thread.thread_id(), std::move(receive_event_ptr));
@@ -354,8 +1102,8 @@ public:
     slice_append(ThisThread::thread_id(), send_event_ptr);
     set_current_thread_ptr(current_thread().parent_thread_ptr());
 
-    if (!s_singleton.m_thread_stack.empty()) {
-      s_singleton.m_thread_stack.pop();
+    if (!singleton().m_thread_stack.empty()) {
+      singleton().m_thread_stack.pop();
     }
 
     return send_event_ptr;
@@ -366,7 +1114,7 @@ public:
   /// \pre: There are no unfinished thread recordings in progress
   /// \remark The precondition is ensured by Threads::reset()
   static void begin_main_thread() {
-    assert(s_singleton.m_thread_stack.empty());
+    assert(singleton().m_thread_stack.empty());
     begin_thread();
   }
 
@@ -376,7 +1124,7 @@ public:
   ///
   /// \returns is there at least one error condition to check?
   static bool end_main_thread(Encoders& encoders) {
-    assert(s_singleton.m_thread_stack.size() == 1);
+    assert(singleton().m_thread_stack.size() == 1);
     end_thread();
     return encode(encoders);
   }
@@ -385,13 +1133,13 @@ public:
   ///
   /// \pre: when called, there are only unconditional events in the main thread
   static void begin_slice_loop() {
-    assert(s_singleton.m_thread_stack.size() == 1);
-    assert(s_singleton.m_slice_map.size() == 1);
+    assert(singleton().m_thread_stack.size() == 1);
+    assert(singleton().m_slice_map.size() == 1);
 
-    s_singleton.m_main_thread_id = ThisThread::thread_id();
-    const Slice& main_slice = s_singleton.m_slice_map.at(
-      s_singleton.m_main_thread_id);
-    s_singleton.m_main_init_event_ptrs = main_slice.current_block_body();
+    singleton().m_main_thread_id = ThisThread::thread_id();
+    const Slice& main_slice = singleton().m_slice_map.at(
+      singleton().m_main_thread_id);
+    singleton().m_main_init_event_ptrs = main_slice.current_block_body();
   }
 
   /// Symbolically encodes all sliced memory accesses between threads
@@ -399,38 +1147,541 @@ public:
   /// \returns is there at least one error condition to check?
   static bool encode(Encoders& encoders) {
     ZoneRelation<Event> zone_relation;
+    BlockingEventPtrs blocking_event_ptrs;
+    internal_encode_threads(zone_relation, blocking_event_ptrs, encoders);
+    const bool has_error_conditions = internal_encode_errors(encoders);
+    internal_encode_interleavings(zone_relation, blocking_event_ptrs, encoders);
+    return has_error_conditions;
+  }
+
+  /// Calls end_thread() and then checks the error conditions in two phases
+
+  /// Many slices are infeasible because of their own path conditions, e.g.
+  /// nested branches that contradict each other. Such slices are refuted
+  /// by a small query over the error conditions and their path conditions
+  /// without encoding any memory accesses. All other slices are encoded as
+  /// by encode(Encoders&) and solved incrementally by the same solver.
+  ///
+  /// \pre begin_main_thread() must have been called previously
+  ///
+  /// \returns smt::sat if and only if an error condition is satisfiable,
+  ///   in particular smt::unsat if there is no error condition
+  static smt::CheckResult two_phase_check(Encoders& encoders) {
+    assert(singleton().m_thread_stack.size() == 1);
+    end_thread();
+
+    return internal_two_phase_check(encoders);
+  }
+
+  /// Calls end_thread() and then checks the error conditions with a cheap pre-check
+
+  /// The pre-check encodes all threads at once but leaves out when events
+  /// happen: a read can return any value that is written to the read's zone,
+  /// no matter by which thread and whether the write happens before or after
+  /// the read. It avoids the read-from, from-read and write-serialization
+  /// axioms, but it still solves one formula over all threads, so it does
+  /// not scale better with the number of threads. If no error is reachable
+  /// even then, the pre-check proves the program safe. Otherwise, the
+  /// interleavings of the threads are encoded as by encode(Encoders&), and
+  /// solved again.
+  ///
+  /// \pre begin_main_thread() must have been called previously
+  ///
+  /// \returns smt::sat if and only if an error condition is satisfiable,
+  ///   in particular smt::unsat if there is no error condition
+  static smt::CheckResult unordered_precheck(Encoders& encoders) {
+    assert(singleton().m_thread_stack.size() == 1);
+    end_thread();
+
+    ZoneRelation<Event> zone_relation;
+    BlockingEventPtrs blocking_event_ptrs;
+    internal_encode_threads(zone_relation, blocking_event_ptrs, encoders);
+    if (!internal_encode_errors(encoders)) {
+      return smt::unsat;
+    }
+
     const Z3OrderEncoderC0 order_encoder;
+    encoders.solver.push();
+    order_encoder.encode_unordered_rf(zone_relation, encoders);
+    const smt::CheckResult precheck_result = encoders.solver.check();
+    encoders.solver.pop();
 
-#ifdef __USE_MATRIX__
-    const Clock epoch_clock("epoch");
-#else
-    const Clock epoch_clock(smt::any<ClockSort>("epoch"));
-#endif
-    for (SliceMap::const_reference slice_map_value : s_singleton.m_slice_map) {
-      const std::shared_ptr<Block> most_outer_block_ptr =
-        slice_map_value.second.most_outer_block_ptr();
-      internal_encode_spo(most_outer_block_ptr, epoch_clock, zone_relation, encoders);
+    if (precheck_result == smt::unsat) {
+      return smt::unsat;
     }
 
-    bool has_error_conditions = !s_singleton.m_error_exprs.empty();
-    if (has_error_conditions) {
-      smt::UnsafeTerm some_error_expr(smt::literal<smt::Bool>(false));
-      for (const smt::UnsafeTerm& error_expr : s_singleton.m_error_exprs) {
-        some_error_expr = some_error_expr or error_expr;
+    internal_encode_interleavings(zone_relation, blocking_event_ptrs, encoders);
+    return encoders.solver.check();
+  }
+
+  /// Structural description of the recorded threads and their conditions
+
+  /// The fingerprint covers the series-parallel graph of every thread,
+  /// including the events' zones and instructions, as well as all the
+  /// conditions that have been given to error() and expect(). It does not
+  /// depend on any Encoders, and it is the same across runs of the same
+  /// build as long as the program is recorded in the same way after reset().
+  /// Threads are only distinguished by the order in which they have been
+  /// started.
+  static Fingerprint program_fingerprint() {
+    std::vector<ThreadId> thread_ids;
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      thread_ids.push_back(slice_map_value.first);
+    }
+    std::sort(thread_ids.begin(), thread_ids.end());
+
+    // thread identifiers keep increasing after reset(), unlike event ones
+    Fingerprint fingerprint;
+    for (ThreadId thread_id : thread_ids) {
+      fingerprint.append(1);
+      internal_fingerprint(
+        *singleton().m_slice_map.at(thread_id).most_outer_block_ptr(),
+        fingerprint);
+    }
+
+    fingerprint.append(singleton().m_condition_fingerprint);
+    return fingerprint;
+  }
+
+  /// Calls end_thread() and then checks the error conditions unless cached
+
+  /// If the cache has a verdict for the program_fingerprint() of the recorded
+  /// threads, it is returned without encoding anything. Otherwise, the
+  /// threads are checked as by two_phase_check(Encoders&), and the
+  /// verdict is cached unless it is smt::unknown.
+  ///
+  /// The fingerprint covers the conditions of expect() and internal_error(),
+  /// but not what is asserted directly in the solver, which cannot be seen
+  /// by the library. Such constraints must be given to expect() instead, or
+  /// be identified by the salt of the verdict cache.
+  ///
+  /// \pre begin_main_thread() must have been called previously
+  ///
+  /// \returns smt::sat if and only if an error condition is satisfiable,
+  ///   in particular smt::unsat if there is no error condition
+  static smt::CheckResult cached_check(VerdictCache& verdict_cache,
+    Encoders& encoders) {
+
+    assert(singleton().m_thread_stack.size() == 1);
+    end_thread();
+
+    const Fingerprint fingerprint(program_fingerprint());
+    smt::CheckResult verdict = verdict_cache.find(fingerprint);
+    if (verdict != smt::unknown) {
+      singleton().m_error_exprs.clear();
+      return verdict;
+    }
+
+    verdict = internal_two_phase_check(encoders);
+    verdict_cache.insert(fingerprint, verdict);
+    return verdict;
+  }
+
+  /// Bounded model checking with incremental loop unwinding
+
+  /// The program, a function without arguments, is recorded once as the
+  /// main thread, with every loop unwound max_unwinding_bound times. The
+  /// bound of each loop is then raised incrementally, starting from one.
+  /// Every unwinding depth only encodes the events of the loop iterations
+  /// that the new bounds include, see Z3OrderEncoderC0::encode_increment(),
+  /// and keeps them in the solver for the next depth. The axioms of the
+  /// synchronization events and the assumptions that the loops exit within
+  /// their current bounds are added in a nested scope of the solver.
+  ///
+  /// If the error conditions cannot be satisfied by such executions, the
+  /// unwinding assertion of each loop is checked, i.e. whether the loop can
+  /// be executed once more than its current bound while all the other
+  /// loops stay within theirs. Only the loops whose unwinding assertion
+  /// fails get a higher bound. All scopes are popped before the function
+  /// returns, so the solver is left as it was.
+  ///
+  /// \returns smt::sat if an error is found, smt::unsat if all loops have
+  ///   been fully unwound and no error exists, and smt::unknown if a loop
+  ///   would have to be unwound more than max_unwinding_bound times
+  template<typename Program>
+  static smt::CheckResult unwinding_check(Program program,
+    unsigned max_unwinding_bound, Encoders& encoders) {
+
+    assert(0 < max_unwinding_bound);
+
+    reset();
+    singleton().m_default_unwinding_bound = max_unwinding_bound;
+
+    begin_main_thread();
+    program();
+    end_thread();
+
+    if (singleton().m_error_exprs.empty()) {
+      return smt::unsat;
+    }
+
+    const smt::UnsafeTerm error_expr(internal_error_expr());
+    singleton().m_error_exprs.clear();
+
+    std::unordered_set<unsigned> loop_policy_ids;
+    UnwindingBlocks unwinding_blocks;
+    for (const UnwindingCondition& unwinding_condition :
+         singleton().m_unwinding_condition_ptrs) {
+
+      loop_policy_ids.insert(unwinding_condition.loop_policy_id);
+      if (unwinding_condition.block_ptr) {
+        unwinding_blocks.iterations.insert(std::make_pair(
+          unwinding_condition.block_ptr.get(), std::make_pair(
+            unwinding_condition.loop_policy_id, unwinding_condition.iteration)));
       }
-      encoders.solver.unsafe_add(some_error_expr);
+    }
 
-      s_singleton.m_error_exprs.clear();
+    // the events of all unwinding depths so far
+    encoders.solver.push();
+
+    const Z3OrderEncoderC0 order_encoder;
+    ZoneRelation<Event> zone_relation;
+    ZoneRelation<Event> increment_zone_relation;
+    BlockingEventPtrs blocking_event_ptrs;
+    internal_encode_threads(increment_zone_relation, blocking_event_ptrs,
+      encoders, &unwinding_blocks);
+    for (unsigned generation = 0; ; generation++) {
+      for (const std::shared_ptr<Event>& event_ptr :
+           increment_zone_relation.event_ptrs()) {
+        zone_relation.relate(event_ptr);
+      }
+      const smt::UnsafeTerm no_pending_expr(order_encoder.encode_increment(
+        zone_relation, increment_zone_relation.event_ptrs(), generation,
+        blocking_event_ptrs.locksets, encoders));
+
+      // only valid for the current unwinding depth
+      encoders.solver.push();
+      encoders.solver.unsafe_add(no_pending_expr);
+      internal_encode_synchronization(blocking_event_ptrs, encoders);
+
+      // only executions that exit every loop within its bound are genuine
+      encoders.solver.push();
+      encoders.solver.unsafe_add(internal_unwinding_bounds_expr(
+        unwinding_blocks.unwinding_bounds, encoders));
+      encoders.solver.unsafe_add(error_expr);
+      const smt::CheckResult error_check_result = encoders.solver.check();
+      encoders.solver.pop();
+
+      if (error_check_result != smt::unsat) {
+        encoders.solver.pop();
+        encoders.solver.pop();
+        return error_check_result;
+      }
+
+      UnwindingBounds unwinding_bounds(unwinding_blocks.unwinding_bounds);
+      bool is_fully_unwound = true;
+      bool is_max_unwinding_bound = false;
+      for (unsigned loop_policy_id : loop_policy_ids) {
+        const UnwindingBounds::const_iterator iter =
+          unwinding_blocks.unwinding_bounds.find(loop_policy_id);
+        const unsigned unwinding_bound =
+          iter == unwinding_blocks.unwinding_bounds.cend() ? 1 : iter->second;
+
+        UnwindingBounds loop_unwinding_bounds(unwinding_blocks.unwinding_bounds);
+        loop_unwinding_bounds[loop_policy_id] = unwinding_bound + 1;
+
+        encoders.solver.push();
+        encoders.solver.unsafe_add(internal_unwinding_bounds_expr(
+          loop_unwinding_bounds, encoders));
+        encoders.solver.unsafe_add(internal_unwinding_expr(loop_policy_id,
+          unwinding_bound + 1, encoders));
+        const smt::CheckResult unwinding_check_result = encoders.solver.check();
+        encoders.solver.pop();
+
+        if (unwinding_check_result == smt::unsat) { continue; }
+
+        is_fully_unwound = false;
+        if (unwinding_bound < max_unwinding_bound) {
+          unwinding_bounds[loop_policy_id] = unwinding_bound + 1;
+        } else {
+          is_max_unwinding_bound = true;
+        }
+      }
+
+      encoders.solver.pop();
+
+      if (is_fully_unwound || is_max_unwinding_bound) {
+        encoders.solver.pop();
+        return is_fully_unwound ? smt::unsat : smt::unknown;
+      }
+
+      unwinding_blocks.unwinding_bounds = unwinding_bounds;
+      increment_zone_relation.clear();
+      internal_encode_deferred_blocks(increment_zone_relation,
+        blocking_event_ptrs, unwinding_blocks, encoders);
     }
+  }
 
-    order_encoder.encode(zone_relation, encoders);
+  /// Is the program recorded for the inductive step of induction_check()?
 
-    return has_error_conditions;
+  /// If so, the program must assign arbitrary values to the variables that
+  /// its loop modifies before it enters the loop, see induction_init().
+  static bool is_inductive_step() {
+    return singleton().m_is_inductive_step;
+  }
+
+  /// \internal Record that the inductive step starts from an arbitrary state
+  static void havoc() {
+    assert(singleton().m_is_inductive_step);
+    singleton().m_is_havocked = true;
+  }
+
+  /// Prove the error conditions in a loop unreachable by k-induction
+
+  /// The program, a function without arguments, is recorded as the main
+  /// thread. Its error conditions must be inside the loop body, i.e. they
+  /// are an invariant of the loop that is checked in every iteration.
+  ///
+  /// For k = 1, 2, ..., max_k, the base case checks whether an error occurs
+  /// in the first k iterations. The inductive step records the program again
+  /// such that is_inductive_step() is true, and unwinds the loop k + 1
+  /// times from that arbitrary state. If no error can occur in the last of
+  /// these iterations while none occurs in the k iterations before it, then
+  /// no error can occur in any iteration. The engine cannot tell where the
+  /// loop starts, so the program has to initialize the variables of its loop
+  /// with induction_init(). If it does not, the inductive step would start
+  /// from the initial state, and the check gives up with smt::unknown rather
+  /// than report a bounded check as a proof. Both cases are encoded and solved
+  /// in their own scope of the solver. Unless the solver proves the absence
+  /// of errors in the base case, its scope is kept, e.g. so that the
+  /// solver's model is a counterexample; otherwise, the solver is
+  /// eventually left as it was.
+  ///
+  /// \returns smt::sat if an error is found, smt::unsat if the error
+  ///   conditions have been proved unreachable, and smt::unknown if the
+  ///   inductive step still fails for max_k or has not been recorded from
+  ///   an arbitrary state
+  template<typename Program>
+  static smt::CheckResult induction_check(Program program, unsigned max_k,
+    Encoders& encoders) {
+
+    assert(0 < max_k);
+
+    for (unsigned k = 1; k <= max_k; k++) {
+      // base case
+      reset();
+      singleton().m_default_unwinding_bound = k;
+
+      begin_main_thread();
+      program();
+      end_thread();
+
+      encoders.solver.push();
+      const bool has_error_conditions = encode(encoders);
+
+      const smt::CheckResult base_check_result = has_error_conditions ?
+        encoders.solver.check() : smt::unsat;
+      if (base_check_result != smt::unsat) {
+        return base_check_result;
+      }
+
+      encoders.solver.pop();
+
+      // inductive step
+      reset();
+      singleton().m_default_unwinding_bound = k + 1;
+      singleton().m_is_inductive_step = true;
+
+      begin_main_thread();
+      program();
+      end_thread();
+
+      if (!singleton().m_is_havocked) {
+        singleton().m_error_exprs.clear();
+        return smt::unknown;
+      }
+
+      encoders.solver.push();
+
+      ZoneRelation<Event> zone_relation;
+      BlockingEventPtrs blocking_event_ptrs;
+      internal_encode_threads(zone_relation, blocking_event_ptrs, encoders);
+      internal_encode_interleavings(zone_relation, blocking_event_ptrs, encoders);
+
+      smt::UnsafeTerm last_error_expr(smt::literal<smt::Bool>(false));
+      for (const std::pair<unsigned, smt::UnsafeTerm>& error_expr :
+           singleton().m_error_exprs) {
+
+        if (error_expr.first <= k) {
+          encoders.solver.unsafe_add(not error_expr.second);
+        } else {
+          last_error_expr = last_error_expr or error_expr.second;
+        }
+      }
+      singleton().m_error_exprs.clear();
+
+      encoders.solver.unsafe_add(last_error_expr);
+      const smt::CheckResult step_check_result = encoders.solver.check();
+      encoders.solver.pop();
+
+      if (step_check_result == smt::unsat) {
+        return smt::unsat;
+      }
+    }
+
+    return smt::unknown;
+  }
+
+  /// Restrict the schedules to at most context_bound context switches
+
+  /// A context switch occurs whenever two consecutive memory accesses in
+  /// the schedule belong to different threads. Since this under-approximates
+  /// the schedules, a satisfiable result is a genuine error, whereas an
+  /// unsatisfiable one only rules out errors within the given bound.
+  ///
+  /// \pre encode(Encoders&) must have been called previously
+  static void encode_context_bound(unsigned context_bound, Encoders& encoders) {
+    std::vector<std::shared_ptr<Event>> memory_event_ptrs;
+    for (SliceMap::const_reference slice_map_value : singleton().m_slice_map) {
+      internal_memory_event_ptrs(*slice_map_value.second.most_outer_block_ptr(),
+        memory_event_ptrs);
+    }
+
+    const Z3OrderEncoderC0 order_encoder;
+    order_encoder.encode_context_bound(memory_event_ptrs, context_bound, encoders);
+  }
+
+  /// Check the error conditions with an increasing context bound
+
+  /// Starting with no context switches at all, the bound is raised one at a
+  /// time until an error is found or max_context_bound has been exhausted.
+  /// The constraints of each bound are added in their own solver scope,
+  /// which is popped again before the next bound is tried or the function
+  /// returns, so the solver is always left as it was. To inspect a
+  /// counterexample, call encode_context_bound(unsigned, Encoders&) with the
+  /// bound that has exposed the error in a scope of its own.
+  ///
+  /// \pre encode(Encoders&) must have been called previously
+  ///
+  /// \returns smt::sat if an error is found, smt::unknown if there is no
+  ///   error within max_context_bound, and the solver's result otherwise
+  static smt::CheckResult context_bounded_check(unsigned max_context_bound,
+    Encoders& encoders) {
+
+    for (unsigned context_bound = 0; context_bound <= max_context_bound;
+         context_bound++) {
+
+      encoders.solver.push();
+      encode_context_bound(context_bound, encoders);
+
+      const smt::CheckResult check_result = encoders.solver.check();
+      encoders.solver.pop();
+      if (check_result != smt::unsat) {
+        return check_result;
+      }
+    }
+
+    return smt::unknown;
+  }
+
+  /// Calls end_thread() and then checks the error conditions in parallel
+
+  /// The search space is split into at most max_cubes cubes over the rf
+  /// selectors of the reads with the most candidate writes, see
+  /// Z3OrderEncoderC0::rf_cubes(). The threads are encoded once for every
+  /// job. The first job encodes into the given Encoders, so it keeps what
+  /// the caller has asserted, and every other job into its own Encoders,
+  /// into which the conditions of expect() and internal_error() are asserted
+  /// again. Constraints that are directly added to the given solver are not
+  /// seen by the other jobs, so they must be given to expect() instead. Each
+  /// job builds its own cubes before any job starts solving, and solves one
+  /// cube after another in its own solver scope until a cube is satisfiable
+  /// or no cube is left. Only the calling thread touches the recorded
+  /// threads. Afterwards, the given solver is left with the encoding of the
+  /// threads and their error conditions, as with end_main_thread(Encoders&).
+  ///
+  /// \pre begin_main_thread() must have been called previously
+  ///
+  /// \returns smt::sat if some cube is satisfiable, smt::unknown if the
+  ///   solver gave up on some cube, and smt::unsat otherwise, in particular
+  ///   if there is no error condition to check
+  static smt::CheckResult cube_and_conquer_check(unsigned jobs,
+    size_t max_cubes, Encoders& encoders) {
+
+    assert(0 < jobs);
+    assert(singleton().m_thread_stack.size() == 1);
+    end_thread();
+
+    const ErrorExprs error_exprs(singleton().m_error_exprs);
+    if (error_exprs.empty()) {
+      return smt::unsat;
+    }
+
+    const Z3OrderEncoderC0 order_encoder;
+    std::vector<std::vector<smt::UnsafeTerm>> job_cubes(jobs);
+    std::vector<std::unique_ptr<Encoders>> encoders_ptrs;
+    std::vector<Encoders*> job_encoders_ptrs;
+    for (unsigned job = 0; job < jobs; job++) {
+      Encoders* job_encoders_ptr = &encoders;
+      if (job != 0) {
+        encoders_ptrs.emplace_back(new Encoders());
+        job_encoders_ptr = encoders_ptrs.back().get();
+        for (const smt::UnsafeTerm& assumption_expr :
+             singleton().m_assumption_exprs) {
+          job_encoders_ptr->solver.unsafe_add(assumption_expr);
+        }
+      }
+
+      Encoders& job_encoders = *job_encoders_ptr;
+      ZoneRelation<Event> zone_relation;
+      BlockingEventPtrs blocking_event_ptrs;
+      internal_encode_threads(zone_relation, blocking_event_ptrs,
+        job_encoders);
+      singleton().m_error_exprs = error_exprs;
+      internal_encode_errors(job_encoders);
+      internal_encode_interleavings(zone_relation, blocking_event_ptrs,
+        job_encoders);
+
+      // the same events, so every job has the same cubes
+      job_cubes[job] = order_encoder.rf_cubes(zone_relation, max_cubes,
+        job_encoders);
+      job_encoders_ptrs.push_back(job_encoders_ptr);
+    }
+
+    std::atomic<size_t> next_cube(0);
+    std::atomic<bool> is_sat(false);
+    std::atomic<bool> is_unknown(false);
+
+    std::vector<std::thread> workers;
+    for (unsigned job = 0; job < jobs; job++) {
+      Encoders& job_encoders = *job_encoders_ptrs[job];
+      const std::vector<smt::UnsafeTerm>& cubes = job_cubes[job];
+      workers.emplace_back([&job_encoders, &cubes, &next_cube, &is_sat,
+        &is_unknown] {
+
+        size_t cube;
+        while (!is_sat && (cube = next_cube++) < cubes.size()) {
+          job_encoders.solver.push();
+          job_encoders.solver.unsafe_add(cubes[cube]);
+          switch (job_encoders.solver.check()) {
+          case smt::sat:
+            is_sat = true;
+            break;
+          case smt::unknown:
+            is_unknown = true;
+            break;
+          default:
+            break;
+          }
+          job_encoders.solver.pop();
+        }
+      });
+    }
+
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    if (is_sat) {
+      return smt::sat;
+    }
+
+    return is_unknown ? smt::unknown : smt::unsat;
   }
 
   static void join(const std::shared_ptr<SendEvent>& send_event_ptr) {
     std::unique_ptr<ReceiveEvent> receive_event_ptr(new ReceiveEvent(
-      ThisThread::thread_id(), send_event_ptr->zone(),
+      ThisThread::thread_id(), send_event_ptr,
       ThisThread::path_condition_ptr()));
 
     slice_append(ThisThread::thread_id(), std::move(receive_event_ptr));
@@ -444,16 +1695,24 @@ public:
   /// \warning Path conditions are ignored and an unsatisfiable error
   ///          condition renders any others unsatisfiable as well
   static void internal_error(std::unique_ptr<ReadInstr<bool>> condition_ptr, Encoders& encoders) {
+    // unlike the conditions of error() and expect(), without path condition
+    Fingerprint fingerprint;
+    fingerprint.append(2);
+    condition_ptr->fingerprint(fingerprint);
+    singleton().m_condition_fingerprint.append(fingerprint);
+
     const ValueEncoder value_encoder;
     const smt::UnsafeTerm condition_expr(value_encoder.encode_eq(
       std::move(condition_ptr), encoders));
 
+    singleton().m_assumption_exprs.push_front(condition_expr);
     encoders.solver.unsafe_add(condition_expr);
   }
 
   /// Assert condition with the current thread's path condition as antecedent
   static void expect(std::unique_ptr<ReadInstr<bool>> condition_ptr, Encoders& encoders) {
     slice_append_all(ThisThread::thread_id(), *condition_ptr);
+    internal_fingerprint_condition(false, *condition_ptr);
 
     const ValueEncoder value_encoder;
     const smt::UnsafeTerm condition_expr(value_encoder.encode_eq(
@@ -461,13 +1720,15 @@ public:
 
     const std::shared_ptr<ReadInstr<bool>> path_condition_ptr(
       ThisThread::path_condition_ptr());
+    smt::UnsafeTerm assumption_expr(condition_expr);
     if (path_condition_ptr) {
       const ReadInstrEncoder read_encoder;
-      encoders.solver.unsafe_add(implies(path_condition_ptr->encode(read_encoder, encoders),
-        condition_expr));
-    } else {
-      encoders.solver.unsafe_add(condition_expr);
+      assumption_expr = implies(path_condition_ptr->encode(read_encoder, encoders),
+        condition_expr);
     }
+
+    singleton().m_assumption_exprs.push_front(assumption_expr);
+    encoders.solver.unsafe_add(assumption_expr);
   }
 
   /// Assert condition in the SAT solver and record the condition's read events
@@ -476,30 +1737,37 @@ public:
   ///         multiple of them to be checked simultaneously by the SAT solver
   static void error(std::unique_ptr<ReadInstr<bool>> condition_ptr, Encoders& encoders) {
     slice_append_all(ThisThread::thread_id(), *condition_ptr);
+    internal_fingerprint_condition(true, *condition_ptr);
+    singleton().m_error_count++;
 
     const ValueEncoder value_encoder;
     const smt::UnsafeTerm error_condition_expr(value_encoder.encode_eq(
       std::move(condition_ptr), encoders));
 
+    const unsigned unwinding_depth = current_thread().m_unwinding_depth;
     const std::shared_ptr<ReadInstr<bool>> path_condition_ptr(
       ThisThread::path_condition_ptr());
     if (path_condition_ptr) {
       const ReadInstrEncoder read_encoder;
-      s_singleton.m_error_exprs.push_front(error_condition_expr and
-        path_condition_ptr->encode(read_encoder, encoders));
+      singleton().m_error_exprs.push_front(std::make_pair(unwinding_depth,
+        error_condition_expr and path_condition_ptr->encode(read_encoder, encoders)));
     } else {
-      s_singleton.m_error_exprs.push_front(error_condition_expr);
+      singleton().m_error_exprs.push_front(std::make_pair(unwinding_depth,
+        error_condition_expr));
     }
   }
 };
 
 template<typename Function, typename... Args>
 Thread::Thread(Function&& f, Args&&... args) :
-  m_thread_id(s_next_thread_id++),
+  m_thread_id(next_thread_id()++),
   m_parent_thread_ptr(&Threads::current_thread()),
   m_send_event_ptr(nullptr),
   m_condition_ptrs_size(0),
-  m_condition_ptrs() {
+  m_condition_ptrs(),
+  m_path_condition_ptr_cache(),
+  m_unwinding_depth(0),
+  m_atomic_depth(0) {
 
   Threads::begin_thread(this);
   f(args...);
@@ -5,6 +5,9 @@
 #ifndef LIBSE_CONCURRENT_VAR_H_
 #define LIBSE_CONCURRENT_VAR_H_
 
+#include <set>
+#include <array>
+#include <vector>
 #include <utility>
 #include <memory>
 
@@ -23,6 +26,9 @@ std::unique_ptr<ReadInstr<T>> alloc_read_instr(const LocalVar<T>& var);
 template<typename T>
 std::unique_ptr<ReadInstr<T>> alloc_read_instr(const SharedVar<T>& var);
 
+template<typename T, size_t N>
+std::unique_ptr<ReadInstr<T[N]>> alloc_read_instr(const SharedVar<T[N]>& var);
+
 template<typename T>
 std::unique_ptr<ReadInstr<typename std::enable_if<
   std::is_arithmetic<T>::value, T>::type>> alloc_read_instr(const T& literal);
@@ -46,8 +52,10 @@ std::unique_ptr<ReadEvent<T>> internal_make_read_event(const Zone& zone,
 
 /// Every object has a \ref DeclVar<T>::zone() "zone" that allows events to be
 /// linked up according to the partial order encoding axioms. In the case of
-/// pointers and arrays, the variable's zone is the same as any dereferenced
-/// memory reachable through it, e.g. `p[3].addr() == p.addr()` for a pointer.
+/// pointers, the variable's zone is the same as any dereferenced memory
+/// reachable through it, e.g. `p[3].addr() == p.addr()` for a pointer. A
+/// shared array element at a literal index has a narrower zone of its own,
+/// see DeclVar<T[N]>::element_zone(size_t).
 ///
 /// If a DeclVar<T>'s zone is not \ref Zone::is_bottom() "bottom", the variable
 /// is said to be "shared". Otherwise, the variable is called "thread-local".
@@ -132,20 +140,31 @@ public:
 };
 
 /// Fixed-sized array declaration
+
+/// A shared array has one zone atom per element, and the array's zone is the
+/// join of these atoms. It labels the array's initialization and every store
+/// through a symbolic index. A load or store through a literal index only
+/// reads and writes the element's zone, so it only relates to events that
+/// can affect the same element. Therefore, the array term of such a store
+/// is only up-to-date at its element, and any read of the entire array, for
+/// example to access it through a symbolic index, reads each element in its
+/// zone, see make_read_instr().
 template<typename T, size_t N>
 class DeclVar<T[N]> {
 static_assert(0 < N, "N must be greater than zero");
 
 private:
+  // Empty if the array is thread-local, otherwise one atom per element
+  const std::vector<Zone> m_element_zones;
+
   const Zone m_zone;
   const std::shared_ptr<DirectWriteEvent<T[N]>> m_direct_write_event_ptr;
   std::shared_ptr<IndirectWriteEvent<T, size_t, N>> m_indirect_write_event_ptr;
 
   template<typename U>
   static std::shared_ptr<DirectWriteEvent<U>> make_direct_write_event(
-    const Zone& zone) {
+    const Zone& zone, std::unique_ptr<ReadInstr<U>> instr_ptr) {
 
-    std::unique_ptr<ReadInstr<U>> instr_ptr(new LiteralReadInstr<U>());
     const std::shared_ptr<DirectWriteEvent<U>> direct_write_event_ptr(
       new DirectWriteEvent<U>(ThisThread::thread_id(), zone,
         std::move(instr_ptr)));
@@ -153,15 +172,93 @@ private:
     return direct_write_event_ptr;
   }
 
+  static std::vector<Zone> make_element_zones(bool is_shared) {
+    std::vector<Zone> element_zones;
+    if (!is_shared) {
+      return element_zones;
+    }
+
+    element_zones.reserve(N);
+    for (size_t index = 0; index < N; index++) {
+      element_zones.push_back(Zone::unique_atom());
+    }
+
+    return element_zones;
+  }
+
+  static Zone join_zones(bool is_shared,
+    const std::vector<Zone>& element_zones) {
+
+    if (!is_shared) {
+      return Zone::bottom();
+    }
+
+    std::set<unsigned> atoms;
+    for (const Zone& element_zone : element_zones) {
+      atoms.insert(element_zone.m_atoms.cbegin(), element_zone.m_atoms.cend());
+    }
+
+    return Zone(std::move(atoms));
+  }
+
 public:
+  /// Zone of the entire array
   const Zone& zone() const { return m_zone; }
 
+  /// Zone of loads and stores of the element at the given literal index
+  const Zone& element_zone(size_t index) const {
+    assert(index < N);
+
+    if (m_element_zones.empty()) {
+      return m_zone;
+    }
+
+    return m_element_zones[index];
+  }
+
+  /// Read of the entire array whose elements are up-to-date
+
+  /// If the array is shared, each element is read in its own zone.
+  std::unique_ptr<ReadInstr<T[N]>> make_read_instr() const {
+    if (m_element_zones.empty()) {
+      return std::unique_ptr<ReadInstr<T[N]>>(new BasicReadInstr<T[N]>(
+        make_read_event<T[N]>(m_zone)));
+    }
+
+    typename ElementsReadInstr<T[N]>::OperandPtrs operand_ptrs;
+    operand_ptrs.reserve(N);
+    for (const Zone& element_zone : m_element_zones) {
+      operand_ptrs.push_back(std::unique_ptr<ReadInstr<T[N]>>(
+        new BasicReadInstr<T[N]>(make_read_event<T[N]>(element_zone))));
+    }
+
+    return std::unique_ptr<ReadInstr<T[N]>>(new ElementsReadInstr<T[N]>(
+      std::move(operand_ptrs)));
+  }
+
   /// Declare a fixed-sized array
 
   /// \param is_shared - can other threads modify any array elements?
-  DeclVar(bool is_shared) :
-    m_zone(is_shared ? Zone::unique_atom() : Zone::bottom()),
-    m_direct_write_event_ptr(make_direct_write_event<T[N]>(m_zone)),
+  /// \param v - initial value of every array element
+  DeclVar(bool is_shared, const T v = 0) :
+    m_element_zones(make_element_zones(is_shared)),
+    m_zone(join_zones(is_shared, m_element_zones)),
+    m_direct_write_event_ptr(make_direct_write_event<T[N]>(m_zone,
+      std::unique_ptr<ReadInstr<T[N]>>(new LiteralReadInstr<T[N]>(v)))),
+    m_indirect_write_event_ptr() {
+
+    Threads::slice_append(ThisThread::thread_id(), m_direct_write_event_ptr);
+  }
+
+  /// Declare a fixed-sized array with literal elements
+
+  /// \param is_shared - can other threads modify any array elements?
+  /// \param vs - initial value of each array element
+  DeclVar(bool is_shared, const std::array<T, N>& vs) :
+    m_element_zones(make_element_zones(is_shared)),
+    m_zone(join_zones(is_shared, m_element_zones)),
+    m_direct_write_event_ptr(make_direct_write_event<T[N]>(m_zone,
+      std::unique_ptr<ReadInstr<T[N]>>(new LiteralReadInstr<T[N]>(vs)))),
     m_indirect_write_event_ptr() {
 
     Threads::slice_append(ThisThread::thread_id(), m_direct_write_event_ptr);
@@ -198,22 +295,33 @@ private:
   DeclVar<Range[N]>* const m_var_ptr;
   std::unique_ptr<DerefReadInstr<Range[N], Domain>> m_deref_instr_ptr;
 
+  // Zone of a store
+  const Zone m_zone;
+
   /// Memory accessible through a deference instruction
 
   /// \param var_ptr - variable that is affected by an indirect write
   /// \param deref_instr_ptr - instruction to load an array element
   Memory(DeclVar<Range[N]>* const var_ptr,
     std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr) :
-    m_var_ptr(var_ptr), m_deref_instr_ptr(std::move(deref_instr_ptr)) {
+    Memory(var_ptr, std::move(deref_instr_ptr), var_ptr->zone()) {}
+
+  /// Memory whose stores are labelled with the given zone
+  Memory(DeclVar<Range[N]>* const var_ptr,
+    std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr,
+    const Zone& zone) :
+    m_var_ptr(var_ptr), m_deref_instr_ptr(std::move(deref_instr_ptr)),
+    m_zone(zone) {
 
     assert(nullptr != m_var_ptr);
     assert(nullptr != m_deref_instr_ptr);
   }
 
   Memory(Memory&& other) : m_var_ptr(other.m_var_ptr),
-    m_deref_instr_ptr(std::move(other.m_deref_instr_ptr)) {}
+    m_deref_instr_ptr(std::move(other.m_deref_instr_ptr)),
+    m_zone(other.m_zone) {}
 
-  const Zone& zone() const { return m_var_ptr->zone(); }
+  const Zone& zone() const { return m_zone; }
 
   void store(std::unique_ptr<ReadInstr<Range>> instr_ptr) {
     assert(nullptr != instr_ptr);
@@ -226,29 +334,66 @@ private:
   }
 };
 
-/// \internal
+/// \internal Shared array element that is either loaded or stored
+
+/// If the element's index is a literal, the element is only loaded from and
+/// stored to the element's zone. Otherwise, the entire array is read and a
+/// store writes the array's zone.
 template<typename Range, typename Domain, size_t N>
 class SharedMemory {
 private:
   template<typename U> friend class SharedVar;
 
-  Memory<Range, Domain, N> m_memory;
- 
+  // Never null until the element is either loaded or stored
+  DeclVar<Range[N]>* const m_var_ptr;
+  std::unique_ptr<ReadInstr<Domain>> m_offset_instr_ptr;
+
+  // Either the array's zone or, for a literal index, the element's zone
+  const Zone m_zone;
+
+  std::unique_ptr<DerefReadInstr<Range[N], Domain>> make_deref_instr() {
+    assert(nullptr != m_offset_instr_ptr);
+
+    std::unique_ptr<ReadInstr<Range[N]>> memory_instr_ptr;
+    if (m_zone == m_var_ptr->zone()) {
+      memory_instr_ptr = m_var_ptr->make_read_instr();
+    } else {
+      memory_instr_ptr.reset(new BasicReadInstr<Range[N]>(
+        make_read_event<Range[N]>(m_zone)));
+    }
+
+    return std::unique_ptr<DerefReadInstr<Range[N], Domain>>(
+      new DerefReadInstr<Range[N], Domain>(std::move(memory_instr_ptr),
+        std::move(m_offset_instr_ptr)));
+  }
+
+  /// \param var_ptr - array that contains the element
+  /// \param offset_instr_ptr - index of the element
+  /// \param zone - zone of loads from and stores to the element
   SharedMemory(DeclVar<Range[N]>* const var_ptr,
-    std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr) :
-    m_memory(var_ptr, std::move(deref_instr_ptr)) {}
+    std::unique_ptr<ReadInstr<Domain>> offset_instr_ptr,
+    const Zone& zone) :
+    m_var_ptr(var_ptr), m_offset_instr_ptr(std::move(offset_instr_ptr)),
+    m_zone(zone) {
+
+    assert(nullptr != m_var_ptr);
+    assert(nullptr != m_offset_instr_ptr);
+  }
 
-  SharedMemory(SharedMemory&& other) : m_memory(std::move(other.m_memory)) {}
+  SharedMemory(SharedMemory&& other) : m_var_ptr(other.m_var_ptr),
+    m_offset_instr_ptr(std::move(other.m_offset_instr_ptr)),
+    m_zone(other.m_zone) {}
 
 public:
-  const Zone& zone() const { return m_memory.zone(); }
+  const Zone& zone() const { return m_zone; }
 
   std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr() {
-    return std::move(m_memory.m_deref_instr_ptr);
+    return make_deref_instr();
   }
 
   void operator=(std::unique_ptr<ReadInstr<Range>> instr_ptr) {
-    m_memory.store(std::move(instr_ptr));
+    Memory<Range, Domain, N> memory(m_var_ptr, make_deref_instr(), m_zone);
+    memory.store(std::move(instr_ptr));
   }
 
   template<typename U>
@@ -330,6 +475,21 @@ public:
     m_local_read(internal_make_read_event<T>(m_var.zone(),
       m_var.direct_write_event_ref().event_id())) {}
 
+  /// Array whose elements are all initialized to the same value
+  template<size_t N = std::extent<T>::value,
+    class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
+  LocalVar(const typename std::remove_extent<T>::type v) : m_var(false, v),
+    m_local_read(internal_make_read_event<T>(m_var.zone(),
+      m_var.direct_write_event_ref().event_id())) {}
+
+  /// Array whose i-th element is initialized to the i-th value
+  template<size_t N = std::extent<T>::value,
+    class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
+  LocalVar(const std::array<typename std::remove_extent<T>::type, N>& vs) :
+    m_var(false, vs),
+    m_local_read(internal_make_read_event<T>(m_var.zone(),
+      m_var.direct_write_event_ref().event_id())) {}
+
   LocalVar(const LocalVar& other) : m_var(false, alloc_read_instr(other)),
     m_local_read(internal_make_read_event<T>(m_var.zone(),
       m_var.direct_write_event_ref().event_id())) {}
@@ -417,12 +577,45 @@ public:
 template<typename T>
 class SharedVar {
 private:
+  template<typename U, size_t N>
+  friend std::unique_ptr<ReadInstr<U[N]>> alloc_read_instr(
+    const SharedVar<U[N]>& var);
+
   DeclVar<T> m_var;
 
+  // records a thread-local write of the given value, and returns a read of
+  // that write so that the value can be used again without re-evaluating it
+  template<typename V>
+  static std::shared_ptr<ReadEvent<V>> store_local(
+    std::unique_ptr<ReadInstr<V>> instr_ptr) {
+
+    const std::shared_ptr<DirectWriteEvent<V>> write_event_ptr(
+      ThisThread::instr(Zone::bottom(), std::move(instr_ptr)));
+
+    return std::shared_ptr<ReadEvent<V>>(internal_make_read_event<V>(
+      Zone::bottom(), write_event_ptr->event_id()));
+  }
+
+  // thread-local copy of the variable's current value
+  std::shared_ptr<ReadEvent<T>> load_local() const {
+    return store_local(alloc_read_instr(*this));
+  }
+
 public:
   SharedVar() : m_var(true) {}
   SharedVar(const T v) : m_var(true, v) {}
 
+  /// Array whose elements are all initialized to the same value
+  template<size_t N = std::extent<T>::value,
+    class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
+  SharedVar(const typename std::remove_extent<T>::type v) : m_var(true, v) {}
+
+  /// Array whose i-th element is initialized to the i-th value
+  template<size_t N = std::extent<T>::value,
+    class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
+  SharedVar(const std::array<typename std::remove_extent<T>::type, N>& vs) :
+    m_var(true, vs) {}
+
   const Zone& zone() const { return m_var.zone(); }
 
   const DirectWriteEvent<T>& direct_write_event_ref() const {
@@ -453,6 +646,88 @@ public:
     return *this;
   }
 
+  /// Atomically add to the variable's value
+
+  /// \returns value before the addition
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<T>> fetch_add(std::unique_ptr<ReadInstr<T>> instr_ptr) {
+    static_assert(std::is_same<T,
+      typename ReturnType<ADD, T, T>::result_type>::value,
+      "Addition must not promote the variable's type");
+
+    ThisThread::begin_atomic();
+    const std::shared_ptr<ReadEvent<T>> old_read_event_ptr(load_local());
+    operator=(std::unique_ptr<ReadInstr<T>>(new BinaryReadInstr<ADD, T, T>(
+      std::unique_ptr<ReadInstr<T>>(new BasicReadInstr<T>(old_read_event_ptr)),
+      std::move(instr_ptr))));
+    ThisThread::end_atomic();
+
+    return std::unique_ptr<ReadInstr<T>>(new BasicReadInstr<T>(
+      old_read_event_ptr));
+  }
+
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<T>> fetch_add(const T v) {
+    return fetch_add(alloc_read_instr(v));
+  }
+
+  /// Atomically replace the variable's value
+
+  /// \returns value before the replacement
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<T>> exchange(std::unique_ptr<ReadInstr<T>> instr_ptr) {
+    ThisThread::begin_atomic();
+    const std::shared_ptr<ReadEvent<T>> old_read_event_ptr(load_local());
+    operator=(std::move(instr_ptr));
+    ThisThread::end_atomic();
+
+    return std::unique_ptr<ReadInstr<T>>(new BasicReadInstr<T>(
+      old_read_event_ptr));
+  }
+
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<T>> exchange(const T v) {
+    return exchange(alloc_read_instr(v));
+  }
+
+  /// Atomically replace the variable's value if it equals an expected value
+
+  /// \returns true if and only if the variable's value has been replaced
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<bool>> compare_exchange(
+    std::unique_ptr<ReadInstr<T>> expected_instr_ptr,
+    std::unique_ptr<ReadInstr<T>> desired_instr_ptr) {
+
+    ThisThread::begin_atomic();
+    const std::shared_ptr<ReadEvent<bool>> success_read_event_ptr(
+      store_local(std::unique_ptr<ReadInstr<bool>>(
+        new BinaryReadInstr<EQL, T, T>(std::unique_ptr<ReadInstr<T>>(
+          new BasicReadInstr<T>(load_local())),
+            std::move(expected_instr_ptr)))));
+    ThisThread::begin_then(std::shared_ptr<ReadInstr<bool>>(
+      new BasicReadInstr<bool>(success_read_event_ptr)));
+    operator=(std::move(desired_instr_ptr));
+    ThisThread::end_branch();
+    ThisThread::end_atomic();
+
+    return std::unique_ptr<ReadInstr<bool>>(new BasicReadInstr<bool>(
+      success_read_event_ptr));
+  }
+
+  template<typename U = T,
+    class = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+  std::unique_ptr<ReadInstr<bool>> compare_exchange(const T expected,
+    const T desired) {
+
+    return compare_exchange(alloc_read_instr(expected),
+      alloc_read_instr(desired));
+  }
+
   /// Literal index
   template<size_t N = std::extent<T>::value,
     class = typename std::enable_if<std::is_array<T>::value and 0 < N>::type>
@@ -465,11 +740,8 @@ public:
     std::unique_ptr<ReadInstr<Domain>> index_read_instr_ptr(
       new LiteralReadInstr<Domain>(index));
 
-    std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr(
-      new DerefReadInstr<Range[N], Domain>(alloc_read_instr(*this),
-        std::move(index_read_instr_ptr)));
-
-    return SharedMemory<Range, Domain, N>(&m_var, std::move(deref_instr_ptr));
+    return SharedMemory<Range, Domain, N>(&m_var,
+      std::move(index_read_instr_ptr), m_var.element_zone(index));
   }
 
   /// Potentially symbolic index
@@ -481,11 +753,8 @@ public:
     typedef typename std::remove_extent<T>::type Range;
     typedef size_t Domain;
 
-    std::unique_ptr<DerefReadInstr<Range[N], Domain>> deref_instr_ptr(
-      new DerefReadInstr<Range[N], Domain>(alloc_read_instr(*this),
-        alloc_read_instr(index)));
-
-    return SharedMemory<Range, Domain, N>(&m_var, std::move(deref_instr_ptr));
+    return SharedMemory<Range, Domain, N>(&m_var, alloc_read_instr(index),
+      m_var.zone());
   }
 
   template<typename U = T, size_t N = std::extent<U>::value,
@@ -503,6 +772,21 @@ std::unique_ptr<ReadInstr<T>> any() {
     make_read_event<T>(/* thread-local */ Zone::bottom())));
 }
 
+/// Initial value of a variable that a loop modifies
+
+/// In the inductive step of Threads::induction_check(), the variable may
+/// have any value when the loop is entered. Otherwise, it has the given one.
+template<typename T, class = typename std::enable_if<
+  std::is_arithmetic<T>::value>::type>
+std::unique_ptr<ReadInstr<T>> induction_init(const T v) {
+  if (Threads::is_inductive_step()) {
+    Threads::havoc();
+    return any<T>();
+  }
+
+  return alloc_read_instr(v);
+}
+
 }
 
 #endif
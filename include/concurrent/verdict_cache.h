@@ -0,0 +1,243 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef LIBSE_CONCURRENT_VERDICT_CACHE_H_
+#define LIBSE_CONCURRENT_VERDICT_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <smt>
+
+#include "concurrent/fingerprint.h"
+
+namespace se {
+
+/// Persistent map from program fingerprints to their verdicts
+
+/// The cache is backed by a binary file in native byte order. It starts
+/// with a header that consists of a magic string, the format version and
+/// the salt of the cache. Each record that follows consists of the number
+/// of fingerprint words, the words themselves and one byte for the verdict.
+///
+/// The salt is derived from the compiler, the encoding options and a salt
+/// that the caller chooses. Since the encoder is mostly header-only, the
+/// library cannot tell by itself whether a verdict was made by the same
+/// encoding. So the caller's salt must identify both the revision of the
+/// library and the program, e.g. by their version control revisions. If the
+/// header of an existing file does not match, its records were made by
+/// another encoding or program, so they are discarded and the file starts
+/// over. Otherwise, all records are loaded when the cache is constructed,
+/// and each new verdict is appended to the file immediately, so separate
+/// runs with the same salt can share the file.
+///
+/// Lookups are by a salted 64-bit hash of the fingerprint, but a verdict is
+/// only returned if all the fingerprint words are equal, so hash collisions
+/// never cause a wrong verdict. A default-constructed cache has no file and
+/// only lives in memory. Only smt::sat and smt::unsat are ever cached.
+class VerdictCache {
+public:
+  typedef uint64_t Key;
+
+  /// Must be incremented whenever the file layout changes
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+private:
+  typedef std::vector<size_t> Words;
+
+  struct Record {
+    Words words;
+    smt::CheckResult verdict;
+  };
+
+  typedef std::unordered_multimap<Key, Record> Records;
+
+  const std::string m_path;
+  const Key m_salt;
+  Records m_records;
+  mutable unsigned m_hit_count;
+
+  // verdict byte of a record
+  enum RecordVerdict : char { SAT_RECORD = 's', UNSAT_RECORD = 'u' };
+
+  static const char* magic() {
+    return "libse-vc";
+  }
+
+  // identifies the build together with the caller's salt
+  static Key build_salt(const std::string& salt) {
+    std::string build("build");
+#ifdef __VERSION__
+    build += " compiler " __VERSION__;
+#endif
+#ifdef __BYTE_ORDER__
+    build += " byte order " + std::to_string(__BYTE_ORDER__);
+#endif
+#ifdef __USE_BV__
+    build += " bv";
+#endif
+#ifdef __USE_MATRIX__
+    build += " matrix";
+#endif
+    build += " word " + std::to_string(sizeof(size_t));
+    build += '\0';
+    build += salt;
+    return Fingerprint::fnv1a(build.data(), build.size());
+  }
+
+  Key key(const Words& words) const {
+    return Fingerprint::fnv1a(words.data(), words.size() * sizeof(size_t),
+      m_salt);
+  }
+
+  // \returns record whose fingerprint words are equal, or nullptr
+  const Record* internal_find(const Words& words) const {
+    const std::pair<Records::const_iterator, Records::const_iterator> range =
+      m_records.equal_range(key(words));
+    for (Records::const_iterator iter = range.first; iter != range.second; iter++) {
+      if (iter->second.words == words) {
+        return &iter->second;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void internal_insert(Words&& words, smt::CheckResult verdict) {
+    Record* const record_ptr = const_cast<Record*>(internal_find(words));
+    if (record_ptr != nullptr) {
+      record_ptr->verdict = verdict;
+      return;
+    }
+
+    const Key words_key = key(words);
+    const Record record = {std::move(words), verdict};
+    m_records.insert(Records::value_type(words_key, record));
+  }
+
+  // \returns does the file start with the header of this cache?
+  bool load() {
+    std::ifstream file(m_path, std::ios::binary);
+    char file_magic[8];
+    uint32_t format_version;
+    Key salt;
+    if (!(file.read(file_magic, sizeof(file_magic)) &&
+          file.read(reinterpret_cast<char*>(&format_version), sizeof(format_version)) &&
+          file.read(reinterpret_cast<char*>(&salt), sizeof(salt)))) {
+      return false;
+    }
+
+    if (std::memcmp(file_magic, magic(), sizeof(file_magic)) != 0 ||
+        format_version != FORMAT_VERSION || salt != m_salt) {
+      return false;
+    }
+
+    uint64_t size;
+    while (file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+      // a truncated record ends the file
+      Words words;
+      size_t word;
+      while (words.size() < size &&
+             file.read(reinterpret_cast<char*>(&word), sizeof(word))) {
+        words.push_back(word);
+      }
+
+      char verdict;
+      if (words.size() < size || !file.read(&verdict, sizeof(verdict))) {
+        break;
+      }
+
+      if (verdict == SAT_RECORD) {
+        internal_insert(std::move(words), smt::sat);
+      } else if (verdict == UNSAT_RECORD) {
+        internal_insert(std::move(words), smt::unsat);
+      }
+    }
+
+    return true;
+  }
+
+  // discards the contents of the file
+  void write_header() const {
+    std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+    const uint32_t format_version = FORMAT_VERSION;
+    file.write(magic(), 8);
+    file.write(reinterpret_cast<const char*>(&format_version), sizeof(format_version));
+    file.write(reinterpret_cast<const char*>(&m_salt), sizeof(m_salt));
+  }
+
+public:
+  VerdictCache() :
+    m_path(),
+    m_salt(build_salt(std::string())),
+    m_records(),
+    m_hit_count(0) {}
+
+  /// Load all verdicts in the given file, which need not exist yet
+
+  /// The salt is folded into every key. It must change whenever the
+  /// library or the program whose verdicts are cached changes, and it must
+  /// also identify anything that the caller asserts directly in the solver
+  /// rather than through Threads::expect().
+  VerdictCache(const std::string& path, const std::string& salt) :
+    m_path(path),
+    m_salt(build_salt(salt)),
+    m_records(),
+    m_hit_count(0) {
+
+    if (!load()) {
+      write_header();
+    }
+  }
+
+  VerdictCache(const VerdictCache&) = delete;
+
+  /// Number of cached verdicts
+  size_t size() const {
+    return m_records.size();
+  }
+
+  /// Number of times find(const Fingerprint&) has returned a verdict
+  unsigned hit_count() const {
+    return m_hit_count;
+  }
+
+  /// \returns smt::unknown if and only if there is no verdict for the fingerprint
+  smt::CheckResult find(const Fingerprint& fingerprint) const {
+    const Record* const record_ptr = internal_find(fingerprint.words());
+    if (record_ptr == nullptr) {
+      return smt::unknown;
+    }
+
+    m_hit_count++;
+    return record_ptr->verdict;
+  }
+
+  /// Cache and persist the verdict unless it is smt::unknown
+  void insert(const Fingerprint& fingerprint, smt::CheckResult verdict) {
+    if (verdict == smt::unknown) {
+      return;
+    }
+
+    Words words(fingerprint.words());
+    if (!m_path.empty()) {
+      std::ofstream file(m_path, std::ios::binary | std::ios::app);
+      const uint64_t size = words.size();
+      const char record_verdict = verdict == smt::sat ? SAT_RECORD : UNSAT_RECORD;
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      file.write(reinterpret_cast<const char*>(words.data()),
+        words.size() * sizeof(size_t));
+      file.write(&record_verdict, sizeof(record_verdict));
+    }
+
+    internal_insert(std::move(words), verdict);
+  }
+};
+
+}
+
+#endif
@@ -16,11 +16,15 @@ namespace se {
 /// An element in an atomistic lattice
 class Zone {
 public:
-  static unsigned s_next_atom;
   static Zone s_bottom_element;
 
   const std::set<unsigned> m_atoms;
 
+private:
+  // counter of the current Session
+  static unsigned& next_atom();
+
+public:
   // Bottom element
   Zone() : m_atoms() {}
   Zone(std::set<unsigned>&& atoms) : m_atoms(std::move(atoms)) {}
@@ -38,9 +42,9 @@ public:
   Zone(const Zone& other) : m_atoms(other.m_atoms) {}
 
   /// \internal Reset the counter that make() uses
-  static void reset(unsigned atom = 0) { s_next_atom = atom; }
+  static void reset(unsigned atom = 0) { next_atom() = atom; }
 
-  static Zone unique_atom() { return Zone(s_next_atom++); }
+  static Zone unique_atom() { return Zone(next_atom()++); }
   static const Zone& bottom() { return s_bottom_element; }
 
   bool operator==(const Zone& other) const { return m_atoms == other.m_atoms; }
@@ -6,20 +6,20 @@
 #define LIBSE_H_
 
 #include "concurrent.h"
+#include "concurrent/session.h"
 
 namespace se {
 
 class __Start {
 public:
   __Start() {
-    Threads::reset();
-    Threads::begin_main_thread();
+    Session::default_session();
   }
 
   /* NB: destructor would not be called until after exiting main(void) */
 };
 
-/// \internal Constructor of __Start calls Threads::begin_main_thread()
+/// \internal Constructor of __Start begins the default session's main thread
 extern __Start main_thread;
 
 }
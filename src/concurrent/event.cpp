@@ -3,9 +3,68 @@
 // license that can be found in the LICENSE file.
 
 #include "concurrent/event.h"
+#include "concurrent/instr.h"
+#include "concurrent/session.h"
 
 namespace se {
 
-unsigned Event::s_next_id = 0;
+unsigned& Event::next_id() {
+  return Session::current().m_next_event_id;
+}
+
+void Event::fingerprint(Fingerprint& fingerprint) const {
+  fingerprint.append_kind(*this);
+  fingerprint.append_event_id(m_event_id);
+  fingerprint.append(m_zone);
+  fingerprint.append(m_type_ptr->bv_size());
+  fingerprint.append(m_type_ptr->is_signed());
+  if (m_condition_ptr) {
+    m_condition_ptr->fingerprint(fingerprint);
+  } else {
+    fingerprint.append(0);
+  }
+}
+
+void UnlockEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+
+  // critical sections that start at different lock events differ
+  fingerprint.append_event_id(m_lock_event_ptr->event_id());
+}
+
+void BarrierEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  fingerprint.append(m_generation);
+  fingerprint.append(m_count);
+}
+
+void ReceiveEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+
+  // symmetric threads receive from different sends of their parent
+  if (!fingerprint.is_renaming()) {
+    fingerprint.append_event_id(m_send_event_ptr->event_id());
+  }
+}
+
+void AtomicEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  fingerprint.append(m_is_begin);
+}
+
+void NotifyEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  fingerprint.append(m_is_all);
+}
+
+void WakeEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  fingerprint.append_event_id(m_wait_event_ptr->event_id());
+}
+
+void AwaitEvent::fingerprint(Fingerprint& fingerprint) const {
+  Event::fingerprint(fingerprint);
+  m_await_condition_ptr->fingerprint(fingerprint);
+}
 
 }
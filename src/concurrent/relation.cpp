@@ -8,5 +8,6 @@ namespace se {
 
 ReadEventPredicate ReadEventPredicate::s_read_predicate;
 WriteEventPredicate WriteEventPredicate::s_write_predicate;
+AnyEventPredicate AnyEventPredicate::s_any_predicate;
 
 }
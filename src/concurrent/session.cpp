@@ -0,0 +1,16 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "concurrent/session.h"
+
+namespace se {
+
+thread_local Session* Session::s_current_session_ptr = nullptr;
+
+Session& Session::default_session() {
+  static Session s_default_session;
+  return s_default_session;
+}
+
+}
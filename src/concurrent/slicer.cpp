@@ -0,0 +1,140 @@
+// Copyright 2013, Alex Horn. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "concurrent/slicer.h"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#define LIBSE_HAS_FORK 1
+#endif
+
+#ifdef LIBSE_HAS_FORK
+#include <cerrno>
+#include <cstdio>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+namespace se {
+
+#ifdef LIBSE_HAS_FORK
+
+bool Slicer::is_single_threaded() {
+  DIR* const dir_ptr = ::opendir("/proc/self/task");
+  if (dir_ptr == nullptr) {
+    return false;
+  }
+
+  unsigned thread_count = 0;
+  while (const struct dirent* const entry_ptr = ::readdir(dir_ptr)) {
+    if (entry_ptr->d_name[0] != '.') {
+      thread_count++;
+    }
+  }
+  ::closedir(dir_ptr);
+
+  return thread_count == 1;
+}
+
+void Slicer::internal_exit_checkpoint(smt::CheckResult verdict) {
+  assert(m_result_fd != -1);
+
+  // the parent process treats an incomplete result as smt::unknown
+  const CheckpointResult result = {verdict, m_slice_count};
+  const bool is_written =
+    ::write(m_result_fd, &result, sizeof(result)) ==
+    static_cast<ssize_t>(sizeof(result));
+  ::close(m_result_fd);
+
+  // neither flush nor destroy what is shared with the parent process
+  ::_exit(is_written ? 0 : 1);
+}
+
+bool Slicer::internal_checkpoint() {
+  // no need for any other slice
+  if (m_checkpoint_verdict == smt::sat) {
+    return true;
+  }
+
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    m_checkpoint_verdict = join(m_checkpoint_verdict, smt::unknown);
+    return true;
+  }
+
+  // otherwise buffered output would be written by both processes
+  std::fflush(nullptr);
+
+  const pid_t pid = ::fork();
+  if (pid == -1) {
+    ::close(fds[0]);
+    ::close(fds[1]);
+    m_checkpoint_verdict = join(m_checkpoint_verdict, smt::unknown);
+    return true;
+  }
+
+  if (pid == 0) {
+    ::close(fds[0]);
+    if (m_result_fd != -1) {
+      ::close(m_result_fd);
+    }
+
+    m_result_fd = fds[1];
+    m_slice_count = 1;
+    m_checkpoint_verdict = smt::unsat;
+    return false;
+  }
+
+  ::close(fds[1]);
+  CheckpointResult result;
+  if (::read(fds[0], &result, sizeof(result)) !=
+      static_cast<ssize_t>(sizeof(result))) {
+    // the forked process has terminated before it sent its verdict
+    result.verdict = smt::unknown;
+    result.slice_count = 0;
+  }
+  ::close(fds[0]);
+
+  int status;
+  pid_t wait_pid;
+  do {
+    wait_pid = ::waitpid(pid, &status, 0);
+  } while (wait_pid == -1 && errno == EINTR);
+
+  // e.g. the forked process has crashed after it sent its verdict, or
+  // it could not send all of it
+  if (wait_pid != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    result.verdict = smt::unknown;
+  }
+
+  m_slice_count += result.slice_count;
+  m_checkpoint_verdict = join(m_checkpoint_verdict, result.verdict);
+  if (m_checkpoint_verdict == smt::sat && m_result_fd != -1) {
+    internal_exit_checkpoint(smt::sat);
+  }
+
+  return true;
+}
+
+#else
+
+// without fork(), set_checkpointing() never enables checkpointing
+bool Slicer::is_single_threaded() {
+  return false;
+}
+
+void Slicer::internal_exit_checkpoint(smt::CheckResult) {
+  assert(false);
+}
+
+bool Slicer::internal_checkpoint() {
+  assert(false);
+  m_checkpoint_verdict = join(m_checkpoint_verdict, smt::unknown);
+  return true;
+}
+
+#endif
+
+}
@@ -3,16 +3,22 @@
 // license that can be found in the LICENSE file.
 
 #include "concurrent/thread.h"
+#include "concurrent/session.h"
 
 namespace se {
 
-Threads Threads::s_singleton;
-ThreadId Thread::s_next_thread_id(0);
 const std::shared_ptr<ReadInstr<bool>> Thread::s_true_condition_ptr;
 
+Threads& Threads::singleton() {
+  return Session::current().m_threads;
+}
+
+ThreadId& Thread::next_thread_id() {
+  return Session::current().m_next_thread_id;
+}
+
 Encoders& global_encoders() {
-  static Encoders s_encoders;
-  return s_encoders;
+  return Session::current().encoders();
 }
 
 namespace ThisThread {
@@ -43,6 +49,29 @@ namespace ThisThread {
   void end_branch() {
     Threads::current_thread().end_branch();
   }
+
+  bool unwind_loop(std::shared_ptr<ReadInstr<bool>> condition_ptr,
+    const LoopPolicy& policy) {
+    return Threads::current_thread().unwind_loop(condition_ptr, policy);
+  }
+
+  void begin_atomic() {
+    Threads::current_thread().begin_atomic();
+  }
+
+  void end_atomic() {
+    Threads::current_thread().end_atomic();
+  }
+
+  bool is_atomic() {
+    return Threads::current_thread().is_atomic();
+  }
+
+  void await(std::unique_ptr<ReadInstr<bool>> condition_ptr) {
+    Threads::slice_append_all(thread_id(), *condition_ptr);
+    Threads::slice_append(thread_id(), std::make_shared<AwaitEvent>(
+      thread_id(), std::move(condition_ptr), path_condition_ptr()));
+  }
 };
 
 bool Thread::encode() {
@@ -74,6 +103,64 @@ void Thread::end_branch() {
   Threads::slice_end_branch(m_thread_id);
 }
 
+bool Thread::unwind_loop(std::shared_ptr<ReadInstr<bool>> condition_ptr,
+  const LoopPolicy& policy) {
+
+  assert(nullptr != condition_ptr);
+
+  const unsigned unwinding_bound = Threads::unwinding_bound(policy);
+  if (Threads::slice_unwind_loop(m_thread_id, condition_ptr, policy,
+      unwinding_bound)) {
+
+    register_condition(condition_ptr);
+    m_unwinding_depth++;
+
+    // a literal loop condition does not start a new block
+    std::shared_ptr<Block> block_ptr;
+    if (nullptr == Bools::literal_ptr(condition_ptr)) {
+      block_ptr = Threads::slice_current_block_ptr(m_thread_id);
+    }
+    Threads::unwind(policy, Threads::slice_unwinding_iteration(m_thread_id),
+      path_condition_ptr(), block_ptr);
+    return true;
+  }
+
+  // the loop has to be unwound further if its condition still holds
+  const std::shared_ptr<ReadInstr<bool>> loop_path_condition_ptr(
+    path_condition_ptr());
+  if (loop_path_condition_ptr) {
+    ConditionPtrs condition_ptrs;
+    condition_ptrs.push_front(condition_ptr);
+    condition_ptrs.push_front(loop_path_condition_ptr);
+    Threads::unwind(policy, unwinding_bound + 1,
+      std::make_shared<NaryReadInstr<LAND, bool>>(std::move(condition_ptrs), 2));
+  } else {
+    Threads::unwind(policy, unwinding_bound + 1, condition_ptr);
+  }
+
+  for (unsigned k = 0; k < unwinding_bound; k++) {
+    unregister_condition();
+  }
+
+  assert(unwinding_bound <= m_unwinding_depth);
+  m_unwinding_depth -= unwinding_bound;
+
+  return false;
+}
+
+void Thread::begin_atomic() {
+  m_atomic_depth++;
+  Threads::slice_append(m_thread_id,
+    std::make_shared<AtomicEvent>(m_thread_id, true));
+}
+
+void Thread::end_atomic() {
+  assert(0 < m_atomic_depth);
+  m_atomic_depth--;
+  Threads::slice_append(m_thread_id,
+    std::make_shared<AtomicEvent>(m_thread_id, false));
+}
+
 std::shared_ptr<ReadInstr<bool>> Thread::path_condition_ptr() {
   if (m_condition_ptrs_size == 0) {
     return s_true_condition_ptr;
@@ -0,0 +1,372 @@
+#include "concurrent/atomic.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+using namespace se::ops;
+
+TEST(AtomicTest, ReadOwnWriteInAtomicSection) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> shared_var;
+  LocalVar<int> local_var;
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    shared_var = 7;
+    local_var = shared_var;
+  }
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(!(local_var == 7));
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, UnsatSingleWriter) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> shared_var;
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    shared_var = shared_var + 3;
+    shared_var = shared_var + 1;
+  }
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  Threads::error(shared_var == 3, encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, MultipleWriters) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<char> x;
+  SharedVar<char> y;
+  SharedVar<char> z;
+
+  LocalVar<char> a;
+  LocalVar<char> b;
+  LocalVar<char> c;
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    x = 'A';
+    y = 'B';
+    z = 'C';
+  }
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    x = '\1';
+    y = '\2';
+    z = '\3';
+  }
+  Threads::end_thread();
+
+  // Reads are not atomic
+  a = x;
+  b = y;
+  c = z;
+
+  // c0 is only satisfiable if reads interleave with the atomic sections
+  std::unique_ptr<ReadInstr<bool>> c0(a == 'A' && b == '\2' && c == '\3');
+  std::unique_ptr<ReadInstr<bool>> c1(a == 'A' && b == '\2' && c == 'C');
+
+  Threads::end_main_thread(encoders);
+
+  encoders.solver.push();
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  encoders.solver.pop();
+
+  encoders.solver.push();
+
+  Threads::internal_error(std::move(c1), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+
+  encoders.solver.pop();
+}
+
+TEST(AtomicTest, UnsatMultipleWritersAndAtomicReads) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<char> x;
+  SharedVar<char> y;
+  SharedVar<char> z;
+
+  LocalVar<char> a;
+  LocalVar<char> b;
+  LocalVar<char> c;
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    x = 'A';
+    y = 'B';
+    z = 'C';
+  }
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  {
+    Atomic atomic;
+    x = '\1';
+    y = '\2';
+    z = '\3';
+  }
+  Threads::end_thread();
+
+  {
+    Atomic atomic;
+    a = x;
+
+    // nested atomic section
+    {
+      Atomic inner_atomic;
+      b = y;
+    }
+
+    c = z;
+  }
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == 'A' && b == '\2' && c == '\3');
+
+  Threads::end_main_thread(encoders);
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, FetchAddReturnsOldValue) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x = 5;
+  LocalVar<int> a;
+
+  Threads::begin_thread();
+  a = x.fetch_add(2);
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(!(a == 5));
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+// \returns the only read event of the zone in the block or its inner blocks
+static std::shared_ptr<Event> find_read_event_ptr(const Block& block,
+  const Zone& zone) {
+
+  for (const std::shared_ptr<Event>& event_ptr : block.body()) {
+    if (event_ptr->is_read() && event_ptr->zone() == zone) {
+      return event_ptr;
+    }
+  }
+
+  for (const std::shared_ptr<Block>& inner_block_ptr : block.inner_block_ptrs()) {
+    const std::shared_ptr<Event> event_ptr(
+      find_read_event_ptr(*inner_block_ptr, zone));
+    if (event_ptr) {
+      return event_ptr;
+    }
+  }
+
+  return nullptr;
+}
+
+// Z3OrderEncoderC0 links up every write with at most one read, so two
+// increments of the same variable in different threads are unsat no matter
+// whether they are atomic. The concurrent write is therefore checked by the
+// clocks of the increment's load and store rather than by another read.
+TEST(AtomicTest, NoWriteBetweenLoadAndStoreOfFetchAdd) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x = 0;
+  LocalVar<int> a;
+
+  Threads::begin_thread();
+  const ThreadId thread_id = ThisThread::thread_id();
+  a = x.fetch_add(1);
+  const DirectWriteEvent<int>& store_event = x.direct_write_event_ref();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  x = 5;
+  const DirectWriteEvent<int>& write_event = x.direct_write_event_ref();
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == 0);
+  std::unique_ptr<ReadInstr<bool>> c1(a == 5);
+
+  Threads::end_main_thread(encoders);
+
+  const std::shared_ptr<Event> load_event_ptr(find_read_event_ptr(
+    *Threads::slice_most_outer_block_ptr(thread_id), x.zone()));
+  ASSERT_NE(nullptr, load_event_ptr);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  encoders.solver.push();
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  encoders.solver.pop();
+
+  encoders.solver.push();
+  Threads::internal_error(std::move(c1), encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  encoders.solver.pop();
+
+  // otherwise, x would be 1 after both threads even if the load returns 0
+  encoders.solver.add(encoders.clock(*load_event_ptr).happens_before(
+    encoders.clock(write_event)));
+  encoders.solver.add(encoders.clock(write_event).happens_before(
+    encoders.clock(store_event)));
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, WriteBetweenLoadAndStore) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x = 0;
+  LocalVar<int> a;
+
+  Threads::begin_thread();
+  const ThreadId thread_id = ThisThread::thread_id();
+  a = x;
+  x = a + 1;
+  const DirectWriteEvent<int>& store_event = x.direct_write_event_ref();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  x = 5;
+  const DirectWriteEvent<int>& write_event = x.direct_write_event_ref();
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == 0);
+
+  Threads::end_main_thread(encoders);
+
+  const std::shared_ptr<Event> load_event_ptr(find_read_event_ptr(
+    *Threads::slice_most_outer_block_ptr(thread_id), x.zone()));
+  ASSERT_NE(nullptr, load_event_ptr);
+
+  // unlike fetch_add(), the increment can overwrite the concurrent write
+  Threads::internal_error(std::move(c0), encoders);
+  encoders.solver.add(encoders.clock(*load_event_ptr).happens_before(
+    encoders.clock(write_event)));
+  encoders.solver.add(encoders.clock(write_event).happens_before(
+    encoders.clock(store_event)));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(AtomicTest, ExchangeReturnsOldValue) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x = 5;
+  LocalVar<int> a;
+
+  Threads::begin_thread();
+  a = x.exchange(2);
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(!(a == 5));
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, SuccessfulCompareExchange) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  LocalVar<bool> a;
+
+  Threads::begin_thread();
+  a = x.compare_exchange(0, 1);
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == false);
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(AtomicTest, FailedCompareExchange) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x = 3;
+  LocalVar<bool> a;
+
+  Threads::begin_thread();
+  a = x.compare_exchange(0, 1);
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == true);
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
@@ -0,0 +1,119 @@
+#include "concurrent/barrier.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+using namespace se::ops;
+
+TEST(BarrierTest, SatWithoutBarrier) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  Threads::error(!(x == 1), encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(BarrierTest, UnsatSingleWriter) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  Barrier barrier(2);
+
+  Threads::begin_thread();
+  x = 1;
+  barrier.wait();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  barrier.wait();
+  Threads::error(!(x == 1), encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(BarrierTest, Generations) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  LocalVar<int> a;
+  Barrier barrier(2);
+
+  Threads::begin_thread();
+  x = 1;
+  barrier.wait();
+  barrier.wait();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  barrier.wait();
+  a = x;
+  barrier.wait();
+  Threads::end_thread();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == 1);
+  std::unique_ptr<ReadInstr<bool>> c1(a == 2);
+
+  Threads::end_main_thread(encoders);
+
+  encoders.solver.push();
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  encoders.solver.pop();
+
+  Threads::internal_error(std::move(c1), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+static smt::CheckResult check_two_waiting_threads(unsigned count) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  Barrier barrier(count);
+
+  x = 0;
+
+  Threads::begin_thread();
+  barrier.wait();
+  Threads::error(x == 0, encoders);
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  barrier.wait();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  return encoders.solver.check();
+}
+
+TEST(BarrierTest, Participants) {
+  EXPECT_EQ(smt::sat, check_two_waiting_threads(2));
+
+  // the threads wait forever for a third one
+  EXPECT_EQ(smt::unsat, check_two_waiting_threads(3));
+}
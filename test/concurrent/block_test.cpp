@@ -10,11 +10,11 @@ public:
   TestEvent(unsigned event_id) :
     Event(event_id, 0, Zone::unique_atom(), true, &TypeInfo<int>::s_type) {}
 
-  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, TermFactory& helper) const {
     return helper.constant(*this);
   }
 
-  smt::UnsafeTerm constant(Encoders& helper) const { return helper.constant(*this); }
+  smt::UnsafeTerm constant(TermFactory& helper) const { return helper.constant(*this); }
 };
 
 TEST(BlockTest, InsertEvents) {
@@ -0,0 +1,154 @@
+#include "concurrent/condition_variable.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+
+TEST(ConditionVariableTest, SatNotifyOne) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  Mutex mutex;
+  ConditionVariable cv;
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  Threads::error(x == 1, encoders);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  x = 1;
+  cv.notify_one();
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ConditionVariableTest, UnsatNotifyOne) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  Mutex mutex;
+  ConditionVariable cv;
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  Threads::error(!(x == 1), encoders);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  x = 1;
+  cv.notify_one();
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(ConditionVariableTest, NotifyOneWakesAtMostOneThread) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  Mutex mutex;
+  ConditionVariable cv;
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.notify_one();
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(ConditionVariableTest, NotifyAllWakesAllThreads) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  Mutex mutex;
+  ConditionVariable cv;
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex);
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.notify_all();
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ConditionVariableTest, WaitWithPredicate) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  Mutex mutex;
+  ConditionVariable cv;
+
+  Threads::begin_thread();
+  mutex.lock();
+  cv.wait(mutex, [&x]() { return x == 1; });
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  mutex.lock();
+  x = 2;
+  cv.notify_one();
+  mutex.unlock();
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
@@ -694,6 +694,92 @@ TEST(EncoderC0Test, Z3OrderEncoderC0ForRfWithoutCondition) {
   EXPECT_EQ(smt::unsat, encoders.solver.check());
 }
 
+TEST(EncoderC0Test, Z3OrderEncoderC0TranslateOrderExprs) {
+  const unsigned write_thread_id = 7;
+  const unsigned read_thread_id = 8;
+
+  const Z3OrderEncoderC0 encoder;
+  Encoders encoders;
+
+  const Zone zone = Zone::unique_atom();
+  std::unique_ptr<ReadInstr<short>> instr_ptr(new LiteralReadInstr<short>(5));
+  const std::shared_ptr<Event> write_event_ptr(
+    new DirectWriteEvent<short>(write_thread_id, zone, std::move(instr_ptr)));
+  const std::shared_ptr<Event> read_event_ptr(
+    new ReadEvent<short>(read_thread_id, zone));
+
+  OrderExprs exprs;
+  const OrderExprs::Index wr_order(exprs.happens_before(*write_event_ptr,
+    *read_event_ptr));
+  const OrderExprs::Index rw_order(exprs.happens_before(*read_event_ptr,
+    *write_event_ptr));
+
+  std::vector<OrderExprs::Index> orders;
+  orders.push_back(wr_order);
+  orders.push_back(rw_order);
+  const OrderExprs::Index some_order(exprs.disjunction(orders));
+  const OrderExprs::Index both_orders(exprs.conjunction(orders));
+
+  // empty disjunctions are false, and empty conjunctions are true
+  const OrderExprs::Index no_expr(exprs.disjunction(std::vector<OrderExprs::Index>()));
+  const OrderExprs::Index all_expr(exprs.conjunction(std::vector<OrderExprs::Index>()));
+
+  encoders.solver.push();
+  encoders.solver.unsafe_add(encoder.translate(exprs, some_order, encoders));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  encoders.solver.pop();
+
+  encoders.solver.push();
+  encoders.solver.unsafe_add(encoder.translate(exprs, both_orders, encoders));
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+  encoders.solver.pop();
+
+  encoders.solver.push();
+  encoders.solver.unsafe_add(encoder.translate(exprs, no_expr, encoders));
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+  encoders.solver.pop();
+
+  encoders.solver.push();
+  encoders.solver.unsafe_add(encoder.translate(exprs, exprs.negation(all_expr),
+    encoders));
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+  encoders.solver.pop();
+}
+
+TEST(EncoderC0Test, Z3OrderEncoderC0RfCubes) {
+  const unsigned write_thread_id = 7;
+  const unsigned read_thread_id = 8;
+
+  const Z3OrderEncoderC0 encoder;
+  Encoders encoders;
+
+  ZoneRelation<Event> relation;
+
+  const Zone zone = Zone::unique_atom();
+  for (short k = 0; k < 2; k++) {
+    std::unique_ptr<ReadInstr<short>> instr_ptr(new LiteralReadInstr<short>(k));
+    relation.relate(std::shared_ptr<Event>(
+      new DirectWriteEvent<short>(write_thread_id, zone, std::move(instr_ptr))));
+    relation.relate(std::shared_ptr<Event>(
+      new ReadEvent<short>(read_thread_id, zone)));
+  }
+
+  // each read can read from either write or from neither
+  EXPECT_EQ(1, encoder.rf_cubes(relation, 2, encoders).size());
+  EXPECT_EQ(3, encoder.rf_cubes(relation, 8, encoders).size());
+
+  const std::vector<smt::UnsafeTerm> cubes(encoder.rf_cubes(relation, 9, encoders));
+  EXPECT_EQ(9, cubes.size());
+
+  smt::UnsafeTerm some_cube(smt::literal<smt::Bool>(false));
+  for (const smt::UnsafeTerm& cube : cubes) {
+    some_cube = some_cube or cube;
+  }
+
+  encoders.solver.unsafe_add(not some_cube);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
 #ifndef IMPLICIT_WS
 TEST(EncoderC0Test, Z3OrderEncoderC0ForWsWithoutCondition) {
   const unsigned write_thread_major_id = 7;
@@ -722,6 +808,107 @@ TEST(EncoderC0Test, Z3OrderEncoderC0ForWsWithoutCondition) {
   encoders.solver.unsafe_add(encoders.clock(*major_write_event_ptr).simultaneous(encoders.clock(*minor_write_event_ptr)));
   EXPECT_EQ(smt::unsat, encoders.solver.check());
 }
+
+TEST(EncoderC0Test, Z3OrderEncoderC0ForWsWithLocksets) {
+  const unsigned write_thread_major_id = 7;
+  const unsigned write_thread_minor_id = 8;
+
+  const Z3OrderEncoderC0 encoder;
+
+  ZoneRelation<Event> relation;
+
+  const Zone zone = Zone::unique_atom();
+  std::unique_ptr<ReadInstr<short>> major_instr_ptr(new LiteralReadInstr<short>(5));
+  const std::shared_ptr<Event> major_write_event_ptr(
+    new DirectWriteEvent<short>(write_thread_major_id, zone, std::move(major_instr_ptr)));
+
+  std::unique_ptr<ReadInstr<short>> minor_instr_ptr(new LiteralReadInstr<short>(7));
+  const std::shared_ptr<Event> minor_write_event_ptr(
+    new DirectWriteEvent<short>(write_thread_minor_id, zone, std::move(minor_instr_ptr)));
+
+  relation.relate(major_write_event_ptr);
+  relation.relate(minor_write_event_ptr);
+
+  const Zone mutex_zone = Zone::unique_atom();
+  const Zone other_mutex_zone = Zone::unique_atom();
+
+  // critical sections of the same mutex order the writes
+  Locksets same_locksets;
+  same_locksets.emplace(major_write_event_ptr.get(), mutex_zone);
+  same_locksets.emplace(minor_write_event_ptr.get(),
+    mutex_zone.join(other_mutex_zone));
+
+  Encoders same_encoders;
+  same_encoders.solver.unsafe_add(encoder.ws_enc(relation, same_locksets, same_encoders));
+  same_encoders.solver.unsafe_add(same_encoders.clock(*major_write_event_ptr).simultaneous(
+    same_encoders.clock(*minor_write_event_ptr)));
+  EXPECT_EQ(smt::sat, same_encoders.solver.check());
+
+  // critical sections of different mutexes may overlap
+  Locksets different_locksets;
+  different_locksets.emplace(major_write_event_ptr.get(), mutex_zone);
+  different_locksets.emplace(minor_write_event_ptr.get(), other_mutex_zone);
+
+  Encoders different_encoders;
+  different_encoders.solver.unsafe_add(encoder.ws_enc(relation, different_locksets,
+    different_encoders));
+  different_encoders.solver.unsafe_add(different_encoders.clock(*major_write_event_ptr).simultaneous(
+    different_encoders.clock(*minor_write_event_ptr)));
+  EXPECT_EQ(smt::unsat, different_encoders.solver.check());
+}
+
+TEST(EncoderC0Test, Z3OrderEncoderC0ForWsWithInitWrite) {
+  const unsigned main_thread_id = 6;
+  const unsigned write_thread_major_id = 7;
+  const unsigned write_thread_minor_id = 8;
+
+  const Z3OrderEncoderC0 encoder;
+
+  ZoneRelation<Event> relation;
+
+  const Zone zone = Zone::unique_atom();
+  std::unique_ptr<ReadInstr<short>> init_instr_ptr(new LiteralReadInstr<short>(0));
+  const std::shared_ptr<Event> init_write_event_ptr(
+    new DirectWriteEvent<short>(main_thread_id, zone, std::move(init_instr_ptr)));
+
+  std::unique_ptr<ReadInstr<short>> major_instr_ptr(new LiteralReadInstr<short>(5));
+  const std::shared_ptr<Event> major_write_event_ptr(
+    new DirectWriteEvent<short>(write_thread_major_id, zone, std::move(major_instr_ptr)));
+
+  std::unique_ptr<ReadInstr<short>> minor_instr_ptr(new LiteralReadInstr<short>(7));
+  const std::shared_ptr<Event> minor_write_event_ptr(
+    new DirectWriteEvent<short>(write_thread_minor_id, zone, std::move(minor_instr_ptr)));
+
+  relation.relate(init_write_event_ptr);
+  relation.relate(major_write_event_ptr);
+  relation.relate(minor_write_event_ptr);
+
+  const Zone mutex_zone = Zone::unique_atom();
+
+  // the initialization does not need the mutex
+  Locksets init_locksets;
+  init_locksets.emplace(init_write_event_ptr.get(), Zone::bottom());
+  init_locksets.emplace(major_write_event_ptr.get(), mutex_zone);
+  init_locksets.emplace(minor_write_event_ptr.get(), mutex_zone);
+
+  Encoders init_encoders;
+  init_encoders.solver.unsafe_add(encoder.ws_enc(relation, init_locksets, init_encoders));
+  init_encoders.solver.unsafe_add(init_encoders.clock(*major_write_event_ptr).simultaneous(
+    init_encoders.clock(*minor_write_event_ptr)));
+  EXPECT_EQ(smt::sat, init_encoders.solver.check());
+
+  // an unprotected write after a thread creation may race
+  Locksets unprotected_locksets;
+  unprotected_locksets.emplace(major_write_event_ptr.get(), mutex_zone);
+  unprotected_locksets.emplace(minor_write_event_ptr.get(), mutex_zone);
+
+  Encoders unprotected_encoders;
+  unprotected_encoders.solver.unsafe_add(encoder.ws_enc(relation, unprotected_locksets,
+    unprotected_encoders));
+  unprotected_encoders.solver.unsafe_add(unprotected_encoders.clock(*major_write_event_ptr).simultaneous(
+    unprotected_encoders.clock(*minor_write_event_ptr)));
+  EXPECT_EQ(smt::unsat, unprotected_encoders.solver.check());
+}
 #endif
 
 TEST(EncoderC0Test, Z3OrderEncoderC0ForFrWithoutCondition) {
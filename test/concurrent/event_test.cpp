@@ -20,11 +20,11 @@ public:
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
         Event(thread_id, zone, true, &TypeInfo<int>::s_type, condition_ptr) {}
 
-  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, TermFactory& helper) const {
     return helper.constant(*this);
   }
 
-  smt::UnsafeTerm constant(Encoders& helper) const { return helper.constant(*this); }
+  smt::UnsafeTerm constant(TermFactory& helper) const { return helper.constant(*this); }
 };
 
 TEST(EventTest, EventId) {
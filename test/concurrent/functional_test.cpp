@@ -153,12 +153,15 @@ TEST(ConcurrentFunctionalTest, ElseIf) {
   Threads::end_main_thread(encoders);
 }
 
-// Do not introduce any new read events as part of a conditional check
+// Do not introduce any new read events as part of a conditional check,
+// nor a literal that would statically decide the branch
 #define TRUE_READ_INSTR \
-  (std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)))
+  (std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(\
+    std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)))))
 
 #define FALSE_READ_INSTR \
-  (std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)))
+  (std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(\
+    std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)))))
 
 TEST(ConcurrentFunctionalTest, SeriesParallelGraph) {
   Encoders encoders;
@@ -424,12 +427,15 @@ TEST(ConcurrentFunctionalTest, LocalArray) {
 }
 */
 
-// Do not introduce any new read events as part of a conditional check
+// Do not introduce any new read events as part of a conditional check,
+// nor a literal that would statically decide the branch
 #define TRUE_READ_INSTR \
-  (std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)))
+  (std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(\
+    std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)))))
 
 #define FALSE_READ_INSTR \
-  (std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)))
+  (std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(\
+    std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)))))
 
 TEST(ConcurrentFunctionalTest, ThreeThreadsReadWriteScalarSharedVar) {
   Encoders encoders;
@@ -709,6 +715,52 @@ TEST(ConcurrentFunctionalTest, LocalScalarAndLocalArray) {
   EXPECT_EQ(smt::unsat, encoders.solver.check());
 }
 
+TEST(ConcurrentFunctionalTest, UniformLocalArrayInitialization) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  LocalVar<char[5]> a('Z');
+  LocalVar<char> b;
+  b = a[3];
+
+  std::unique_ptr<ReadInstr<bool>> c0(!(b == 'Z'));
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  encoders.solver.push();
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(ConcurrentFunctionalTest, NonUniformLocalArrayInitialization) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  LocalVar<char[4]> a(std::array<char, 4>{{'A', 'Z', 'Z', 'Z'}});
+  LocalVar<char> b;
+  LocalVar<char> c;
+  b = a[0];
+  c = a[2];
+
+  std::unique_ptr<ReadInstr<bool>> c0(!(b == 'A' && c == 'Z'));
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  encoders.solver.push();
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
 TEST(ConcurrentFunctionalTest, SharedScalarVariableInSingleThread) {
   Encoders encoders;
 
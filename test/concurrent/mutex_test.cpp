@@ -3,13 +3,6 @@
 
 using namespace se;
 
-/// Makes Mutex::unlock(Encoders&) public
-class InternalMutex : public Mutex {
-public:
-  InternalMutex() : Mutex() {}
-  void unlock(Encoders& encoders) { return Mutex::unlock(encoders); }
-};
-
 TEST(MutexTest, SatMainThreadSingleWriter) {
   Encoders encoders;
 
@@ -53,19 +46,19 @@ TEST(MutexTest, UnsatSingleWriter) {
   Threads::begin_main_thread();
 
   SharedVar<int> shared_var;
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
   mutex.lock();
   shared_var = shared_var + 3;
   shared_var = shared_var + 1;
-  mutex.unlock(encoders);
+  mutex.unlock();
   Threads::end_thread();
 
   Threads::begin_thread();
   mutex.lock();
   Threads::error(shared_var == 3, encoders);
-  mutex.unlock(encoders);
+  mutex.unlock();
   Threads::end_thread();
 
   Threads::end_main_thread(encoders);
@@ -87,7 +80,7 @@ TEST(MutexTest, Sat1MultipleWriters) {
   LocalVar<char> b;
   LocalVar<char> c;
 
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
 
@@ -95,7 +88,7 @@ TEST(MutexTest, Sat1MultipleWriters) {
   x = 'A';
   y = 'B';
   z = 'C';
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   Threads::end_thread();
 
@@ -105,7 +98,7 @@ TEST(MutexTest, Sat1MultipleWriters) {
   x = '\1';
   y = '\2';
   z = '\3';
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   Threads::end_thread();
 
@@ -148,7 +141,7 @@ TEST(MutexTest, Sat2MultipleWriters) {
   LocalVar<char> b;
   LocalVar<char> c;
 
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
 
@@ -204,7 +197,7 @@ TEST(MutexTest, UnsatMultipleWriters) {
   LocalVar<char> b;
   LocalVar<char> c;
 
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
 
@@ -212,7 +205,7 @@ TEST(MutexTest, UnsatMultipleWriters) {
   x = 'A';
   y = 'B';
   z = 'C';
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   Threads::end_thread();
 
@@ -222,21 +215,21 @@ TEST(MutexTest, UnsatMultipleWriters) {
   x = '\1';
   y = '\2';
   z = '\3';
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   Threads::end_thread();
 
   mutex.lock();
   a = x;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   b = y;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   c = z;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   std::unique_ptr<ReadInstr<bool>> c0(a == 'A' && b == '\2' && c == 'C');
   std::unique_ptr<ReadInstr<bool>> c1(a == '\1' && b == 'B' && c == '\3');
@@ -269,17 +262,17 @@ TEST(MutexTest, SatJoinMultipleWriters) {
 
   SharedVar<int> x = 10;
   SharedVar<int> y = 10;
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
 
   mutex.lock();
   x = x + 1;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   y = y + 1;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   t1_send_event_ptr = Threads::end_thread();
 
@@ -287,11 +280,11 @@ TEST(MutexTest, SatJoinMultipleWriters) {
 
   mutex.lock();
   x = x + 5;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   y = y - 6;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   t2_send_event_ptr = Threads::end_thread();
 
@@ -315,17 +308,17 @@ TEST(MutexTest, UnsatJoinMultipleWriters) {
 
   SharedVar<int> x = 10;
   SharedVar<int> y = 10;
-  InternalMutex mutex;
+  Mutex mutex;
 
   Threads::begin_thread();
 
   mutex.lock();
   x = x + 1;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   y = y + 1;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   t1_send_event_ptr = Threads::end_thread();
 
@@ -333,11 +326,11 @@ TEST(MutexTest, UnsatJoinMultipleWriters) {
 
   mutex.lock();
   x = x + 5;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   mutex.lock();
   y = y - 6;
-  mutex.unlock(encoders);
+  mutex.unlock();
 
   t2_send_event_ptr = Threads::end_thread();
 
@@ -349,3 +342,81 @@ TEST(MutexTest, UnsatJoinMultipleWriters) {
 
   EXPECT_EQ(smt::unsat, encoders.solver.check());
 }
+
+TEST(MutexTest, SatDifferentMutexes) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<char> x;
+  SharedVar<char> y;
+  SharedVar<char> z;
+
+  LocalVar<char> a;
+  LocalVar<char> b;
+  LocalVar<char> c;
+
+  Mutex mutex;
+  Mutex other_mutex;
+
+  Threads::begin_thread();
+
+  mutex.lock();
+  x = 'A';
+  y = 'B';
+  z = 'C';
+  mutex.unlock();
+
+  Threads::end_thread();
+
+  Threads::begin_thread();
+
+  // Critical section may overlap with the one in the other thread
+  other_mutex.lock();
+  x = '\1';
+  y = '\2';
+  z = '\3';
+  other_mutex.unlock();
+
+  Threads::end_thread();
+
+  mutex.lock();
+  a = x;
+  b = y;
+  c = z;
+  mutex.unlock();
+
+  std::unique_ptr<ReadInstr<bool>> c0(a == 'A' && b == '\2' && c == 'C');
+
+  Threads::end_main_thread(encoders);
+
+  Threads::internal_error(std::move(c0), encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(MutexTest, LockWhileSpawningThread) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> shared_var;
+  Mutex mutex;
+
+  mutex.lock();
+
+  Threads::begin_thread();
+  mutex.lock();
+  shared_var = 3;
+  mutex.unlock();
+  Threads::end_thread();
+
+  shared_var = 5;
+  Threads::error(shared_var == 3, encoders);
+  mutex.unlock();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
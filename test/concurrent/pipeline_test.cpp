@@ -0,0 +1,78 @@
+#include <stdexcept>
+
+#include "concurrent.h"
+#include "concurrent/pipeline.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+using namespace se::ops;
+
+TEST(PipelineTest, SliceQueue) {
+  SliceQueue queue(2);
+
+  EXPECT_TRUE(queue.push(SliceQueue::EncodersPtr(new Encoders())));
+  EXPECT_TRUE(queue.push(SliceQueue::EncodersPtr(new Encoders())));
+
+  queue.close();
+  EXPECT_FALSE(queue.push(SliceQueue::EncodersPtr(new Encoders())));
+
+  EXPECT_NE(nullptr, queue.pop());
+  EXPECT_NE(nullptr, queue.pop());
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+static bool record_branch(Slicer& slicer, char error_value, Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<char> x;
+
+  x = 'A';
+  if (slicer.begin_then_branch(__COUNTER__, any<bool>())) {
+    x = 'B';
+  }
+  if (slicer.begin_else_branch(__COUNTER__)) {
+    x = 'C';
+  } slicer.end_branch(__COUNTER__);
+
+  Threads::error(x == error_value, encoders);
+  return Threads::end_main_thread(encoders);
+}
+
+TEST(PipelineTest, SatPipelinedCheck) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  // the first slice takes the "else" branch
+  EXPECT_EQ(smt::sat, pipelined_check(slicer, [&slicer](Encoders& encoders) {
+    return record_branch(slicer, 'B', encoders); }));
+
+  EXPECT_EQ(2, slicer.slice_count());
+}
+
+TEST(PipelineTest, UnsatPipelinedCheck) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  EXPECT_EQ(smt::unsat, pipelined_check(slicer, [&slicer](Encoders& encoders) {
+    return record_branch(slicer, 'D', encoders); }, 2));
+
+  EXPECT_EQ(2, slicer.slice_count());
+}
+
+TEST(PipelineTest, PipelinedCheckWithoutErrors) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  unsigned recorded_slices = 0;
+
+  EXPECT_EQ(smt::unsat, pipelined_check(slicer, [&](Encoders& encoders) {
+    record_branch(slicer, 'B', encoders);
+    recorded_slices++;
+    return false; }));
+
+  EXPECT_EQ(2, recorded_slices);
+}
+
+TEST(PipelineTest, PipelinedCheckRethrows) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  EXPECT_THROW(pipelined_check(slicer, [](Encoders&) -> bool {
+    throw std::runtime_error("cannot record slice"); }), std::runtime_error);
+}
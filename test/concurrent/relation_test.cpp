@@ -14,11 +14,11 @@ public:
     const std::shared_ptr<ReadInstr<bool>>& condition_ptr = nullptr) :
     Event(0, zone, true, &TypeInfo<int>::s_type, condition_ptr) {}
 
-  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, Encoders& helper) const {
+  smt::UnsafeTerm encode_eq(const ValueEncoder& encoder, TermFactory& helper) const {
     return helper.constant(*this);
   }
 
-  smt::UnsafeTerm constant(Encoders& helper) const { return helper.constant(*this); }
+  smt::UnsafeTerm constant(TermFactory& helper) const { return helper.constant(*this); }
 };
 
 TEST(RelationTest, CopyZoneAtom) {
@@ -164,3 +164,61 @@ TEST(RelationTest, ZoneRelationWithJoin) {
   EXPECT_EQ(2, relation.event_ptrs().size());
   EXPECT_EQ(2, relation.find(a_zone, ReadEventPredicate::predicate()).size());
 }
+
+TEST(RelationTest, ZoneAtomsWithSameEvents) {
+  const Zone a_zone = Zone::unique_atom();
+  const Zone b_zone = Zone::unique_atom();
+  const Zone c_zone = Zone::unique_atom();
+  const Zone ab_zone = a_zone.join(b_zone);
+
+  const std::shared_ptr<Event> ab_event_ptr(new TestEvent(ab_zone));
+  const std::shared_ptr<Event> c_event_ptr(new TestEvent(c_zone));
+
+  ZoneRelation<Event> relation;
+
+  relation.relate(ab_event_ptr);
+  relation.relate(c_event_ptr);
+
+  // a and b relate exactly the same events
+  EXPECT_EQ(2, relation.zone_atoms().size());
+  EXPECT_EQ(&relation.zone_atoms(), &relation.zone_atoms());
+
+  const std::shared_ptr<Event> b_event_ptr(new TestEvent(b_zone));
+  relation.relate(b_event_ptr);
+
+  EXPECT_EQ(3, relation.zone_atoms().size());
+
+  relation.clear();
+  EXPECT_TRUE(relation.zone_atoms().empty());
+}
+
+TEST(RelationTest, ZoneRelationComponents) {
+  const Zone a_zone = Zone::unique_atom();
+  const Zone b_zone = Zone::unique_atom();
+  const Zone c_zone = Zone::unique_atom();
+  const Zone d_zone = Zone::unique_atom();
+
+  ZoneRelation<Event> relation;
+
+  relation.relate(std::shared_ptr<Event>(new TestEvent(a_zone)));
+  relation.relate(std::shared_ptr<Event>(new TestEvent(b_zone)));
+  relation.relate(std::shared_ptr<Event>(new TestEvent(c_zone)));
+  relation.relate(std::shared_ptr<Event>(new TestEvent(d_zone)));
+
+  EXPECT_EQ(4, relation.components().size());
+
+  // a and c are connected through an event in both of them
+  relation.relate(std::shared_ptr<Event>(new TestEvent(a_zone.join(c_zone))));
+
+  const std::vector<ZoneRelation<Event>> components(relation.components());
+  EXPECT_EQ(3, components.size());
+
+  size_t event_ptrs_size = 0;
+  for (const ZoneRelation<Event>& component : components) {
+    event_ptrs_size += component.event_ptrs().size();
+    if (!component.find(a_zone, AnyEventPredicate::predicate()).empty()) {
+      EXPECT_EQ(3, component.event_ptrs().size());
+    }
+  }
+  EXPECT_EQ(5, event_ptrs_size);
+}
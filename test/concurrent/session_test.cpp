@@ -0,0 +1,93 @@
+#include <thread>
+#include <vector>
+
+#include "concurrent.h"
+#include "concurrent/session.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+using namespace se::ops;
+
+TEST(SessionTest, Binding) {
+  Session session_a;
+  Session session_b;
+
+  EXPECT_EQ(&Session::default_session(), &Session::current());
+  {
+    Session::Binding binding_a(session_a);
+    EXPECT_EQ(&session_a, &Session::current());
+    EXPECT_EQ(&session_a.encoders(), &Thread::encoders());
+    EXPECT_EQ(0, ReadEvent<int>(0, Zone::unique_atom()).event_id());
+
+    {
+      Session::Binding binding_b(session_b);
+      EXPECT_EQ(&session_b, &Session::current());
+      EXPECT_EQ(0, ReadEvent<int>(0, Zone::unique_atom()).event_id());
+    }
+
+    EXPECT_EQ(&session_a, &Session::current());
+    EXPECT_EQ(1, ReadEvent<int>(0, Zone::unique_atom()).event_id());
+  }
+  EXPECT_EQ(&Session::default_session(), &Session::current());
+}
+
+TEST(SessionTest, ConstructorBeginsMainThread) {
+  Session session;
+  Session::Binding binding(session);
+  Encoders& encoders = session.encoders();
+
+  // no Threads::reset() and Threads::begin_main_thread() needed
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == 2, encoders);
+  EXPECT_TRUE(Threads::end_main_thread(encoders));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+static smt::CheckResult check_write(int value) {
+  Encoders& encoders = Session::current().encoders();
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = value;
+  Threads::end_thread();
+
+  Threads::error(x == 2, encoders);
+  Threads::end_main_thread(encoders);
+
+  return encoders.solver.check();
+}
+
+TEST(SessionTest, ConcurrentSessions) {
+  constexpr unsigned N = 4;
+
+  std::vector<smt::CheckResult> check_results(N, smt::unknown);
+  std::vector<std::thread> workers;
+  for (unsigned n = 0; n < N; n++) {
+    workers.emplace_back([&check_results, n] {
+      Session session;
+      Session::Binding binding(session);
+
+      // only even threads write 2
+      check_results[n] = check_write(2 + n % 2);
+    });
+  }
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  for (unsigned n = 0; n < N; n++) {
+    EXPECT_EQ(n % 2 == 0 ? smt::sat : smt::unsat, check_results[n]);
+  }
+}
@@ -6,6 +6,11 @@ using namespace se;
 #define READ_EVENT_ID(id) (id)
 #define WRITE_EVENT_ID(id) (id)
 
+// Condition that is not a literal but has no read events
+#define NONLITERAL_TRUE_READ_INSTR \
+  (std::unique_ptr<ReadInstr<bool>>(new UnaryReadInstr<NOT, bool>(\
+    std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)))))
+
 TEST(SliceTest, LoopPolicy) {
   constexpr LoopPolicy p(make_loop_policy<7, 2>());
   static_assert(7 == p.id(), "Wrong loop ID");
@@ -119,6 +124,70 @@ TEST(SliceTest, ThenBlockWithEmptyBlock) {
   EXPECT_EQ(slice.current_block_ptr(), most_outer_block_ptr->inner_block_ptrs().back());
 }
 
+TEST(SliceTest, LiteralThenAndElse) {
+  const unsigned thread_id = 3;
+  Slice slice;
+
+  const Zone zone = Zone::unique_atom();
+  slice.append(std::unique_ptr<Event>(new ReadEvent<bool>(thread_id, zone)));
+
+  const std::shared_ptr<Block> most_outer_block_ptr(slice.current_block_ptr()->outer_block_ptr());
+  const std::shared_ptr<Block> initial_block_ptr(slice.current_block_ptr());
+
+  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+
+  // statically decided branch has no blocks
+  EXPECT_EQ(initial_block_ptr, slice.current_block_ptr());
+  slice.append(std::unique_ptr<Event>(new ReadEvent<bool>(thread_id, zone)));
+
+  slice.begin_else();
+
+  EXPECT_EQ(initial_block_ptr, slice.current_block_ptr());
+  EXPECT_EQ(nullptr, slice.current_block_ref().else_block_ptr());
+  slice.append(std::unique_ptr<Event>(new ReadEvent<bool>(thread_id, zone)));
+
+  slice.end_branch();
+
+  EXPECT_EQ(initial_block_ptr, slice.current_block_ptr());
+  EXPECT_EQ(nullptr, slice.current_block_ref().condition_ptr());
+  EXPECT_EQ(3, std::distance(slice.current_block_ref().body().cbegin(),
+    slice.current_block_ref().body().cend()));
+  EXPECT_TRUE(slice.current_block_ref().inner_block_ptrs().empty());
+  EXPECT_EQ(1, most_outer_block_ptr->inner_block_ptrs().size());
+}
+
+TEST(SliceTest, LiteralThenInsideConditionalBlock) {
+  const unsigned thread_id = 3;
+  Slice slice;
+
+  const Zone zone = Zone::unique_atom();
+  std::unique_ptr<ReadEvent<long>> event_ptr(new ReadEvent<long>(thread_id, zone));
+  std::unique_ptr<ReadInstr<long>> linstr_ptr(new BasicReadInstr<long>(std::move(event_ptr)));
+
+  std::unique_ptr<ReadInstr<char>> rinstr_ptr(new LiteralReadInstr<char>('Z'));
+
+  std::unique_ptr<ReadInstr<bool>> condition_ptr(new BinaryReadInstr<LSS, long, char>(
+    std::move(linstr_ptr), std::move(rinstr_ptr)));
+
+  slice.begin_then(std::move(condition_ptr));
+
+  const std::shared_ptr<Block> then_block_ptr(slice.current_block_ptr());
+  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(false)));
+
+  EXPECT_EQ(then_block_ptr, slice.current_block_ptr());
+  EXPECT_TRUE(then_block_ptr->inner_block_ptrs().empty());
+
+  slice.end_branch();
+
+  EXPECT_EQ(then_block_ptr, slice.current_block_ptr());
+  EXPECT_TRUE(then_block_ptr->inner_block_ptrs().empty());
+
+  slice.end_branch();
+
+  EXPECT_EQ(nullptr, slice.current_block_ref().condition_ptr());
+  EXPECT_EQ(slice.most_outer_block_ptr(), slice.current_block_ref().outer_block_ptr());
+}
+
 TEST(SliceTest, ThenBlockWithNonemptyBlock) {
   const unsigned thread_id = 3;
   Slice slice;
@@ -192,7 +261,7 @@ TEST(SliceTest, NestedThenWithEmptyBlock) {
   slice.begin_then(std::move(condition_ptr));
   
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
@@ -245,7 +314,7 @@ TEST(SliceTest, NestedThenWithNonemptyBlock) {
   slice.append(std::unique_ptr<Event>(new ReadEvent<bool>(thread_id, zone)));
 
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
@@ -406,7 +475,7 @@ TEST(SliceTest, ElseWithNestedEmptyBlock) {
   slice.begin_then(std::move(condition_ptr));
   
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
@@ -467,7 +536,7 @@ TEST(SliceTest, ElseWithNestedNonemptyBlock) {
   slice.begin_then(std::move(condition_ptr));
   
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
@@ -526,15 +595,16 @@ TEST(SliceTest, NestedElseWithEmptyBlock) {
   slice.begin_then(std::move(condition_ptr));
   
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
   slice.begin_else();
 
   const UnaryReadInstr<NOT, bool>& not_condition = dynamic_cast<const UnaryReadInstr<NOT, bool>&>(*slice.current_block_ref().condition_ptr());
-  const LiteralReadInstr<bool>& condition = dynamic_cast<const LiteralReadInstr<bool>&>(not_condition.operand_ref());
-  EXPECT_TRUE(condition.literal());
+  const UnaryReadInstr<NOT, bool>& condition = dynamic_cast<const UnaryReadInstr<NOT, bool>&>(not_condition.operand_ref());
+  const LiteralReadInstr<bool>& literal = dynamic_cast<const LiteralReadInstr<bool>&>(condition.operand_ref());
+  EXPECT_FALSE(literal.literal());
 
   EXPECT_TRUE(slice.current_block_ref().body().empty());
   EXPECT_TRUE(slice.current_block_ref().inner_block_ptrs().empty());
@@ -582,15 +652,16 @@ TEST(SliceTest, NestedElseWithNonemptyBlock) {
   slice.begin_then(std::move(condition_ptr));
   
   const std::shared_ptr<Block> outer_then_block_ptr(slice.current_block_ptr());
-  slice.begin_then(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)));
+  slice.begin_then(NONLITERAL_TRUE_READ_INSTR);
 
   EXPECT_EQ(outer_then_block_ptr, slice.current_block_ref().outer_block_ptr());
 
   slice.begin_else();
 
   const UnaryReadInstr<NOT, bool>& not_condition = dynamic_cast<const UnaryReadInstr<NOT, bool>&>(*slice.current_block_ref().condition_ptr());
-  const LiteralReadInstr<bool>& condition = dynamic_cast<const LiteralReadInstr<bool>&>(not_condition.operand_ref());
-  EXPECT_TRUE(condition.literal());
+  const UnaryReadInstr<NOT, bool>& condition = dynamic_cast<const UnaryReadInstr<NOT, bool>&>(not_condition.operand_ref());
+  const LiteralReadInstr<bool>& literal = dynamic_cast<const LiteralReadInstr<bool>&>(condition.operand_ref());
+  EXPECT_FALSE(literal.literal());
 
   EXPECT_TRUE(slice.current_block_ref().body().empty());
   EXPECT_TRUE(slice.current_block_ref().inner_block_ptrs().empty());
@@ -638,7 +709,7 @@ TEST(SliceTest, SimpleLoopWithReuse) {
   EXPECT_EQ(nullptr, initial_block_ptr->condition_ptr());
 
   // k = 1
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_TRUE(continue_unwinding);
 
   // reuse empty and conditional initial block
@@ -648,7 +719,7 @@ TEST(SliceTest, SimpleLoopWithReuse) {
   EXPECT_NE(nullptr, initial_block_ptr->condition_ptr());
 
   // k = 2
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_TRUE(continue_unwinding);
 
   const std::shared_ptr<Block> second_unwound_loop_block_ptr(slice.current_block_ptr());
@@ -659,7 +730,7 @@ TEST(SliceTest, SimpleLoopWithReuse) {
   EXPECT_NE(nullptr, second_unwound_loop_block_ptr->condition_ptr());
 
   // k = 3, stop unrolling!
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_FALSE(continue_unwinding);
 
   EXPECT_NE(second_unwound_loop_block_ptr, slice.current_block_ptr());
@@ -687,7 +758,7 @@ TEST(SliceTest, SimpleLoopWithoutReuse) {
   EXPECT_EQ(nullptr, initial_block_ptr->condition_ptr());
 
   // k = 1
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_TRUE(continue_unwinding);
 
   // cannot reuse nonempty initial block
@@ -701,7 +772,7 @@ TEST(SliceTest, SimpleLoopWithoutReuse) {
   EXPECT_EQ(nullptr, initial_block_ptr->condition_ptr());
 
   // k = 2
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_TRUE(continue_unwinding);
 
   const std::shared_ptr<Block> second_unwound_loop_block_ptr(slice.current_block_ptr());
@@ -712,7 +783,7 @@ TEST(SliceTest, SimpleLoopWithoutReuse) {
   EXPECT_NE(nullptr, second_unwound_loop_block_ptr->condition_ptr());
 
   // k = 3, stop unrolling!
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy);
   EXPECT_FALSE(continue_unwinding);
 
   EXPECT_NE(second_unwound_loop_block_ptr, slice.current_block_ptr());
@@ -722,6 +793,31 @@ TEST(SliceTest, SimpleLoopWithoutReuse) {
   EXPECT_EQ(3, most_outer_block_ptr->inner_block_ptrs().size());
 }
 
+TEST(SliceTest, LoopWithUnwindingBound) {
+  Slice slice;
+
+  constexpr LoopPolicy policy(make_loop_policy<7, 2>());
+  bool continue_unwinding = true;
+
+  const std::shared_ptr<Block> most_outer_block_ptr(slice.most_outer_block_ptr());
+  const std::shared_ptr<Block> initial_block_ptr(slice.current_block_ptr());
+
+  // k = 1
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy, 1);
+  EXPECT_TRUE(continue_unwinding);
+  EXPECT_EQ(initial_block_ptr, slice.current_block_ptr());
+  EXPECT_NE(nullptr, initial_block_ptr->condition_ptr());
+
+  // k = 2, stop unrolling despite the loop policy
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, policy, 1);
+  EXPECT_FALSE(continue_unwinding);
+
+  EXPECT_NE(initial_block_ptr, slice.current_block_ptr());
+  EXPECT_TRUE(initial_block_ptr->inner_block_ptrs().empty());
+  EXPECT_EQ(most_outer_block_ptr, slice.current_block_ptr()->outer_block_ptr());
+  EXPECT_EQ(2, most_outer_block_ptr->inner_block_ptrs().size());
+}
+
 TEST(SliceTest, NestedLoop) {
   const unsigned thread_id = 3;
   Slice slice;
@@ -742,7 +838,7 @@ TEST(SliceTest, NestedLoop) {
   EXPECT_EQ(nullptr, initial_block_ptr->condition_ptr());
 
   // k = 1
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), outer_policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, outer_policy);
   EXPECT_TRUE(continue_unwinding);
 
   // cannot reuse nonempty initial block
@@ -756,7 +852,7 @@ TEST(SliceTest, NestedLoop) {
   EXPECT_EQ(nullptr, initial_block_ptr->condition_ptr());
 
   // j = 1
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), inner_policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, inner_policy);
   EXPECT_TRUE(continue_unwinding);
 
   const std::shared_ptr<Block> second_unwound_loop_block_ptr(slice.current_block_ptr());
@@ -767,7 +863,7 @@ TEST(SliceTest, NestedLoop) {
   EXPECT_NE(nullptr, second_unwound_loop_block_ptr->condition_ptr());
 
   // j = 2, stop inner loop unrolling!
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), inner_policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, inner_policy);
   EXPECT_FALSE(continue_unwinding);
 
   EXPECT_NE(second_unwound_loop_block_ptr, slice.current_block_ptr());
@@ -778,7 +874,7 @@ TEST(SliceTest, NestedLoop) {
   EXPECT_EQ(2, first_unwound_loop_block_ptr->inner_block_ptrs().size());
 
   // k = 2, stop outer loop unrolling!
-  continue_unwinding = slice.unwind_loop(std::unique_ptr<ReadInstr<bool>>(new LiteralReadInstr<bool>(true)), outer_policy);
+  continue_unwinding = slice.unwind_loop(NONLITERAL_TRUE_READ_INSTR, outer_policy);
   EXPECT_FALSE(continue_unwinding);
 
   EXPECT_NE(second_unwound_loop_block_ptr, slice.current_block_ptr());
@@ -1,7 +1,13 @@
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "concurrent.h"
 #include "concurrent/slicer.h"
 #include "gtest/gtest.h"
 
 using namespace se;
+using namespace se::ops;
 
 TEST(SlicerTest, ZeroSliceFreq) {
   Slicer slicer;
@@ -77,3 +83,352 @@ TEST(SlicerTest, MaxSliceFreqThen) {
   EXPECT_FALSE(slicer.next_slice());
   EXPECT_EQ(2, slicer.slice_count());
 }
+
+TEST(SlicerTest, LiteralConditionIsNeverSliced) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  constexpr Location loc = __COUNTER__;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  const std::shared_ptr<Block> block_ptr(ThisThread::most_outer_block_ptr());
+  const std::shared_ptr<ReadInstr<bool>> true_condition_ptr(
+    new LiteralReadInstr<bool>(true));
+
+  EXPECT_TRUE(slicer.begin_then_branch(loc, true_condition_ptr));
+  EXPECT_EQ(nullptr, ThisThread::path_condition_ptr());
+  EXPECT_FALSE(slicer.begin_else_branch(loc + 1));
+  slicer.end_branch(loc + 2);
+
+  const std::shared_ptr<ReadInstr<bool>> false_condition_ptr(
+    new LiteralReadInstr<bool>(false));
+
+  EXPECT_FALSE(slicer.begin_then_branch(loc + 3, false_condition_ptr));
+  EXPECT_EQ(nullptr, ThisThread::path_condition_ptr());
+  EXPECT_TRUE(slicer.begin_else_branch(loc + 4));
+  EXPECT_EQ(nullptr, ThisThread::path_condition_ptr());
+  slicer.end_branch(loc + 5);
+
+  EXPECT_EQ(1, block_ptr->inner_block_ptrs().size());
+  EXPECT_FALSE(slicer.next_slice());
+  EXPECT_EQ(1, slicer.slice_count());
+}
+
+TEST(SlicerTest, ReuseVerdictOfIdenticalSlice) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  constexpr Location loc = __COUNTER__;
+
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> x;
+    SharedVar<int> y;
+    x = 1;
+    y = 1;
+
+    // neither branch has any effect on shared memory
+    const std::shared_ptr<ReadInstr<bool>> condition_ptr(x < 3);
+    slicer.begin_then_branch(loc, condition_ptr);
+    slicer.begin_else_branch(loc + 1);
+    slicer.end_branch(loc + 2);
+
+    Threads::error(y == 2, encoders);
+    EXPECT_EQ(smt::unsat, slicer.check(encoders));
+  } while (slicer.next_slice());
+
+  EXPECT_EQ(2, slicer.slice_count());
+  EXPECT_EQ(1, slicer.reused_verdict_count());
+}
+
+TEST(SlicerTest, CheckSlicesThatDifferOnlyInLiterals) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  constexpr Location loc = __COUNTER__;
+
+  unsigned sat_count = 0;
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> x;
+    SharedVar<int> y;
+    x = 1;
+
+    // both branches record the same events except for the written value
+    const std::shared_ptr<ReadInstr<bool>> condition_ptr(x < 3);
+    if (slicer.begin_then_branch(loc, condition_ptr)) {
+      y = 2;
+    }
+    if (slicer.begin_else_branch(loc + 1)) {
+      y = 3;
+    }
+    slicer.end_branch(loc + 2);
+
+    Threads::error(y == 2, encoders);
+    if (slicer.check(encoders) == smt::sat) {
+      sat_count++;
+    }
+  } while (slicer.next_slice());
+
+  EXPECT_EQ(2, slicer.slice_count());
+  EXPECT_EQ(1, sat_count);
+  EXPECT_EQ(0, slicer.reused_verdict_count());
+}
+
+TEST(SlicerTest, PruneSlicesThatContainUnsatCore) {
+  Slicer slicer(MAX_SLICE_FREQ);
+
+  constexpr Location loc = __COUNTER__;
+
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> x;
+    SharedVar<int> y;
+    SharedVar<int> z;
+    x = 1;
+    y = 1;
+    z = 1;
+
+    const std::shared_ptr<ReadInstr<bool>> outer_condition_ptr(x < 3);
+    if (slicer.begin_then_branch(loc, outer_condition_ptr)) {
+      z = 2;
+    }
+    if (slicer.begin_else_branch(loc + 1)) {
+      // only reached if the outer "then" block is sliced away
+      const std::shared_ptr<ReadInstr<bool>> inner_condition_ptr(y < 3);
+      if (slicer.begin_then_branch(loc + 2, inner_condition_ptr)) {
+        y = 2;
+      }
+      slicer.begin_else_branch(loc + 3);
+      slicer.end_branch(loc + 4);
+    }
+    slicer.end_branch(loc + 5);
+
+    Threads::error(z == 3, encoders);
+    EXPECT_EQ(smt::unsat, slicer.check(encoders));
+  } while (slicer.next_slice());
+
+  // the outer "then" block is checked only once, not for both inner decisions
+  EXPECT_EQ(3, slicer.slice_count());
+  EXPECT_EQ(1, slicer.pruned_slice_count());
+  EXPECT_EQ(0, slicer.reused_verdict_count());
+}
+
+// \returns number of slices of a branch that is nested in another one's "then"
+//   where is_checked says whether the slices are solved by Slicer::check()
+static unsigned count_nested_branch_slices(Slicer& slicer,
+  bool is_checked = true) {
+
+  constexpr Location loc = __COUNTER__;
+
+  smt::CheckResult verdict;
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> x;
+    SharedVar<int> y;
+    x = 1;
+    y = 1;
+
+    const std::shared_ptr<ReadInstr<bool>> outer_condition_ptr(x < 3);
+    if (slicer.begin_then_branch(loc, outer_condition_ptr)) {
+      // first reached by the second slice
+      const std::shared_ptr<ReadInstr<bool>> inner_condition_ptr(x < 2);
+      if (slicer.begin_then_branch(loc + 1, inner_condition_ptr)) {
+        y = 2;
+      }
+      slicer.begin_else_branch(loc + 2);
+      slicer.end_branch(loc + 3);
+    }
+    slicer.begin_else_branch(loc + 4);
+    slicer.end_branch(loc + 5);
+
+    Threads::error(y == 3, encoders);
+    if (is_checked) {
+      verdict = slicer.check(encoders);
+    } else {
+      Threads::end_main_thread(encoders);
+      verdict = encoders.solver.check();
+    }
+    EXPECT_EQ(smt::unsat, verdict);
+  } while (slicer.next_slice());
+
+  // with checkpointing, this also covers the slices of the forked processes,
+  // whose failed expectations are lost when they exit
+  EXPECT_EQ(smt::unsat, verdict);
+
+  return slicer.slice_count();
+}
+
+TEST(SlicerTest, NonZeroSliceFreqSlicesEveryBranch) {
+  Slicer slicer(1);
+  EXPECT_EQ(3, count_nested_branch_slices(slicer));
+
+  Slicer max_slicer(MAX_SLICE_FREQ);
+  EXPECT_EQ(3, count_nested_branch_slices(max_slicer));
+}
+
+TEST(SlicerTest, MergeBranchesUntilSizeIsMeasured) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  slicer.set_adaptive_split(100, 0);
+  EXPECT_EQ(1, count_nested_branch_slices(slicer));
+}
+
+// The prior splits the outer branch, but the first slice is measured to be
+// small, so the inner branch that the second slice reaches is merged.
+TEST(SlicerTest, MergeBranchesOfSmallSlices) {
+  Slicer prior_slicer(MAX_SLICE_FREQ);
+  prior_slicer.set_adaptive_split(100, 200);
+  EXPECT_EQ(2, count_nested_branch_slices(prior_slicer));
+
+  Slicer unchecked_slicer(MAX_SLICE_FREQ);
+  unchecked_slicer.set_adaptive_split(100, 200);
+  EXPECT_EQ(2, count_nested_branch_slices(unchecked_slicer, false));
+
+  // every slice reads x and y
+  Slicer large_slicer(MAX_SLICE_FREQ);
+  large_slicer.set_adaptive_split(2, 200);
+  EXPECT_EQ(3, count_nested_branch_slices(large_slicer));
+
+  Slicer never_slicer;
+  never_slicer.set_adaptive_split(2, 200);
+  EXPECT_EQ(1, count_nested_branch_slices(never_slicer));
+}
+
+// \returns number of slices until the bug after the first of two branches is found
+static unsigned count_slices_to_bug(Slicer& slicer) {
+  constexpr Location loc = __COUNTER__;
+
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> x;
+    SharedVar<int> y;
+    SharedVar<int> z;
+    x = 1;
+    y = 1;
+    z = 1;
+
+    const std::shared_ptr<ReadInstr<bool>> condition_ptr(x < 3);
+    if (slicer.begin_then_branch(loc, condition_ptr)) {
+      z = 2;
+    }
+    slicer.begin_else_branch(loc + 1);
+    slicer.end_branch(loc + 2);
+
+    Threads::error(z == 2, encoders);
+
+    const std::shared_ptr<ReadInstr<bool>> other_condition_ptr(y < 3);
+    slicer.begin_then_branch(loc + 3, other_condition_ptr);
+    slicer.begin_else_branch(loc + 4);
+    slicer.end_branch(loc + 5);
+
+    if (slicer.check(encoders) == smt::sat) {
+      return slicer.slice_count();
+    }
+  } while (slicer.next_slice());
+
+  return 0;
+}
+
+TEST(SlicerTest, PrioritizeBranchesCloseToError) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  EXPECT_EQ(3, count_slices_to_bug(slicer));
+
+  Slicer prioritized_slicer(MAX_SLICE_FREQ);
+  prioritized_slicer.set_prioritization(true);
+  EXPECT_EQ(2, count_slices_to_bug(prioritized_slicer));
+}
+
+TEST(SlicerTest, PrioritizedSlicesCoverAllDecisions) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  slicer.set_prioritization(true);
+  EXPECT_EQ(3, count_nested_branch_slices(slicer));
+}
+
+TEST(SlicerTest, CheckpointedSlices) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  ASSERT_TRUE(slicer.set_checkpointing(true));
+  EXPECT_EQ(3, count_nested_branch_slices(slicer));
+}
+
+TEST(SlicerTest, CheckpointedSliceExposesBug) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  ASSERT_TRUE(slicer.set_checkpointing(true));
+
+  // the slices that skip the "then" blocks are forked first
+  EXPECT_EQ(4, count_slices_to_bug(slicer));
+}
+
+TEST(SlicerTest, CheckpointedSliceOfForkedProcessExposesBug) {
+  Slicer slicer(MAX_SLICE_FREQ);
+  ASSERT_TRUE(slicer.set_checkpointing(true));
+
+  constexpr Location loc = __COUNTER__;
+
+  smt::CheckResult verdict;
+  do {
+    Encoders encoders;
+
+    Threads::reset();
+    Threads::begin_main_thread();
+
+    SharedVar<int> z;
+    z = 1;
+
+    // the original process executes the "then" block
+    slicer.begin_then_branch(loc, any<bool>());
+    if (slicer.begin_else_branch(loc + 1)) {
+      z = 2;
+    }
+    slicer.end_branch(loc + 2);
+
+    Threads::error(z == 2, encoders);
+    verdict = slicer.check(encoders);
+  } while (verdict != smt::sat && slicer.next_slice());
+
+  EXPECT_EQ(smt::sat, verdict);
+  EXPECT_EQ(2, slicer.slice_count());
+}
+
+TEST(SlicerTest, CheckpointingRequiresSingleThread) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool is_done = false;
+
+  // e.g. the solving stage of pipelined_check()
+  std::thread other_thread([&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&is_done] { return is_done; });
+  });
+
+  Slicer slicer(MAX_SLICE_FREQ);
+  EXPECT_FALSE(slicer.set_checkpointing(true));
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    is_done = true;
+  }
+  cv.notify_one();
+  other_thread.join();
+
+  // the slices are recorded from the beginning instead
+  EXPECT_EQ(3, count_nested_branch_slices(slicer));
+}
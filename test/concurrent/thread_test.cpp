@@ -1,7 +1,8 @@
-#include "concurrent/thread.h"
+#include "concurrent.h"
 #include "gtest/gtest.h"
 
 using namespace se;
+using namespace se::ops;
 
 bool function_call;
 
@@ -49,3 +50,807 @@ TEST(ThreadTest, FunctionCallWithPointerArgs) {
   Thread thread(f3, function_call_ptr);
   EXPECT_TRUE(function_call);
 }
+
+TEST(ThreadTest, SatWithoutAwait) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> flag;
+  SharedVar<int> data;
+
+  Threads::begin_thread();
+  data = 42;
+  flag = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  Threads::error(!(data == 42), encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, UnsatAwait) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> flag;
+  SharedVar<int> data;
+
+  Threads::begin_thread();
+  data = 42;
+  flag = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  ThisThread::await(flag == 1);
+  Threads::error(!(data == 42), encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+TEST(ThreadTest, SatAwait) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> flag;
+  SharedVar<int> data;
+
+  Threads::begin_thread();
+  data = 42;
+  flag = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  ThisThread::await(flag == 1);
+  Threads::error(data == 42, encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, SatBeforeJoin) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  x = 1;
+  const std::shared_ptr<SendEvent> send_event_ptr = Threads::end_thread();
+
+  Threads::error(!(x == 1), encoders);
+  Threads::join(send_event_ptr);
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, UnsatJoin) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  x = 1;
+  const std::shared_ptr<SendEvent> send_event_ptr = Threads::end_thread();
+
+  Threads::join(send_event_ptr);
+  Threads::error(!(x == 1), encoders);
+
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+static std::shared_ptr<Event> first_event_ptr(ThreadId thread_id) {
+  return Threads::slice_most_outer_block_ptr(thread_id)->
+    inner_block_ptrs().front()->body().front();
+}
+
+TEST(ThreadTest, SymmetricThreads) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::set_symmetry_reduction(true);
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  const ThreadId thread_id_a = ThisThread::thread_id();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  const ThreadId thread_id_b = ThisThread::thread_id();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::error(x == 1, encoders);
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  encoders.solver.push();
+  encoders.solver.add(encoders.clock(*first_event_ptr(thread_id_b)).happens_before(
+    encoders.clock(*first_event_ptr(thread_id_a))));
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+  encoders.solver.pop();
+}
+
+TEST(ThreadTest, AsymmetricThreads) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::set_symmetry_reduction(true);
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  const ThreadId thread_id_a = ThisThread::thread_id();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  const ThreadId thread_id_b = ThisThread::thread_id();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == 1, encoders);
+  Threads::end_main_thread(encoders);
+
+  encoders.solver.add(encoders.clock(*first_event_ptr(thread_id_b)).happens_before(
+    encoders.clock(*first_event_ptr(thread_id_a))));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, NestedAndSequentialAtomicSectionsAreAsymmetric) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::set_symmetry_reduction(true);
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  // nested atomic sections, both writes are indivisible
+  Threads::begin_thread();
+  const ThreadId thread_id_a = ThisThread::thread_id();
+  ThisThread::begin_atomic();
+  ThisThread::begin_atomic();
+  x = 1;
+  ThisThread::end_atomic();
+  x = 2;
+  ThisThread::end_atomic();
+  Threads::end_thread();
+
+  // sequential atomic sections, the same events in the same order except
+  // that the second one ends instead of beginning an atomic section
+  Threads::begin_thread();
+  const ThreadId thread_id_b = ThisThread::thread_id();
+  ThisThread::begin_atomic();
+  ThisThread::end_atomic();
+  x = 1;
+  ThisThread::begin_atomic();
+  x = 2;
+  ThisThread::end_atomic();
+  Threads::end_thread();
+
+  Threads::error(x == 2, encoders);
+  Threads::end_main_thread(encoders);
+
+  encoders.solver.add(encoders.clock(*first_event_ptr(thread_id_b)).happens_before(
+    encoders.clock(*first_event_ptr(thread_id_a))));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, SymmetricThreadsWithoutReduction) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+
+  Threads::begin_thread();
+  const ThreadId thread_id_a = ThisThread::thread_id();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  const ThreadId thread_id_b = ThisThread::thread_id();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::error(x == 1, encoders);
+  Threads::end_main_thread(encoders);
+
+  encoders.solver.add(encoders.clock(*first_event_ptr(thread_id_b)).happens_before(
+    encoders.clock(*first_event_ptr(thread_id_a))));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, ContextBound) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 0;
+
+  Threads::begin_thread();
+  x = 1;
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == 1, encoders);
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+
+  // main thread, child thread, main thread and child thread again
+  encoders.solver.push();
+  Threads::encode_context_bound(2, encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+  encoders.solver.pop();
+
+  encoders.solver.push();
+  Threads::encode_context_bound(3, encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  encoders.solver.pop();
+}
+
+TEST(ThreadTest, ContextBoundedCheck) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 0;
+
+  Threads::begin_thread();
+  x = 1;
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == 1, encoders);
+  Threads::end_main_thread(encoders);
+
+  EXPECT_EQ(smt::unknown, Threads::context_bounded_check(2, encoders));
+  EXPECT_EQ(smt::sat, Threads::context_bounded_check(5, encoders));
+
+  // the scope of the exposing bound has been popped as well
+  EXPECT_EQ(smt::unknown, Threads::context_bounded_check(2, encoders));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, UnorderedPrecheckWithoutComposition) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  // no thread ever writes 3
+  Threads::error(x == 3, encoders);
+
+  EXPECT_EQ(smt::unsat, Threads::unordered_precheck(encoders));
+}
+
+TEST(ThreadTest, UnorderedPrecheckWithComposition) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  // 2 is only written after it is read
+  Threads::error(x == 2, encoders);
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  EXPECT_EQ(smt::unsat, Threads::unordered_precheck(encoders));
+}
+
+TEST(ThreadTest, SatUnorderedPrecheck) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == 2, encoders);
+
+  EXPECT_EQ(smt::sat, Threads::unordered_precheck(encoders));
+}
+
+TEST(ThreadTest, UnorderedPrecheckWithoutErrors) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  EXPECT_EQ(smt::unsat, Threads::unordered_precheck(encoders));
+}
+
+TEST(ThreadTest, CubeAndConquerCheck) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 0;
+
+  Threads::begin_thread();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  Threads::error(x == 2, encoders);
+  Threads::end_thread();
+
+  EXPECT_EQ(smt::sat, Threads::cube_and_conquer_check(2, 4, encoders));
+}
+
+TEST(ThreadTest, UnsatCubeAndConquerCheck) {
+  Encoders encoders;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 0;
+
+  Threads::begin_thread();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  // no thread ever writes 3
+  Threads::begin_thread();
+  Threads::error(x == 3, encoders);
+  Threads::end_thread();
+
+  EXPECT_EQ(smt::unsat, Threads::cube_and_conquer_check(3, 4, encoders));
+}
+
+static void record_expected_writes(Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 0;
+
+  Threads::begin_thread();
+  x = 1;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  LocalVar<int> a;
+  a = x;
+  Threads::expect(!(a == 2), encoders);
+  Threads::error(a == 2, encoders);
+  Threads::end_thread();
+}
+
+TEST(ThreadTest, CubeAndConquerCheckWithExpect) {
+  Encoders encoders;
+  record_expected_writes(encoders);
+  Threads::end_main_thread(encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+
+  // every job asserts the expectation
+  Encoders cube_encoders;
+  record_expected_writes(cube_encoders);
+  EXPECT_EQ(smt::unsat, Threads::cube_and_conquer_check(3, 8, cube_encoders));
+}
+
+static void record_two_variables(int y_value, Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+  Threads::set_encoding_jobs(2);
+
+  SharedVar<int> x;
+  SharedVar<int> y;
+  x = 1;
+  y = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  y = 3;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  Threads::error(x == 2 && y == y_value, encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+}
+
+TEST(ThreadTest, ParallelEncoding) {
+  Encoders encoders;
+  record_two_variables(3, encoders);
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+}
+
+TEST(ThreadTest, UnsatParallelEncoding) {
+  Encoders encoders;
+
+  // no thread ever writes 2 to y
+  record_two_variables(2, encoders);
+  EXPECT_EQ(smt::unsat, encoders.solver.check());
+}
+
+static constexpr size_t many_variables = 16;
+
+// every variable is its own component of the zone relation
+static void record_many_variables(int value, Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+  Threads::set_encoding_jobs(8);
+
+  std::unique_ptr<SharedVar<int>> vars[many_variables];
+  for (std::unique_ptr<SharedVar<int>>& var : vars) {
+    var.reset(new SharedVar<int>(0));
+  }
+
+  for (int thread_value = 1; thread_value <= 2; thread_value++) {
+    Threads::begin_thread();
+    for (std::unique_ptr<SharedVar<int>>& var : vars) {
+      *var = thread_value;
+    }
+    Threads::end_thread();
+  }
+
+  Threads::begin_thread();
+  std::unique_ptr<ReadInstr<bool>> condition_ptr(*vars[0] == value);
+  for (size_t i = 1; i < many_variables; i++) {
+    condition_ptr = std::move(condition_ptr) && *vars[i] == value;
+  }
+  Threads::error(std::move(condition_ptr), encoders);
+  Threads::end_thread();
+
+  Threads::end_main_thread(encoders);
+}
+
+TEST(ThreadTest, ParallelEncodingOfManyComponents) {
+  // more components than jobs so that every job encodes several of them
+  for (unsigned n = 0; n < 4; n++) {
+    Encoders sat_encoders;
+    record_many_variables(2, sat_encoders);
+    EXPECT_EQ(smt::sat, sat_encoders.solver.check());
+
+    Encoders unsat_encoders;
+    record_many_variables(3, unsat_encoders);
+    EXPECT_EQ(smt::unsat, unsat_encoders.solver.check());
+  }
+}
+
+TEST(ThreadTest, UnwindingCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    int k = 0;
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      x = ++k;
+    }
+
+    Threads::error(x == 2, encoders);
+  }, 5, encoders);
+
+  EXPECT_EQ(smt::sat, check_result);
+}
+
+TEST(ThreadTest, UnwindingCheckPopsScopes) {
+  Encoders encoders;
+
+  EXPECT_EQ(smt::sat, Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    int k = 0;
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      x = ++k;
+    }
+
+    Threads::error(x == 2, encoders);
+  }, 5, encoders));
+
+  // no scope is left for the caller to pop
+  EXPECT_EQ(smt::sat, Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 7;
+
+    Threads::error(x == 7, encoders);
+  }, 5, encoders));
+}
+
+TEST(ThreadTest, UnwindingCheckReadsEarlierIterations) {
+  Encoders encoders;
+
+  // every iteration reads the write of the previous one, which an
+  // earlier unwinding depth has encoded
+  const smt::CheckResult check_result = Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      x = x + 1;
+    }
+
+    Threads::error(x == 3, encoders);
+  }, 5, encoders);
+
+  EXPECT_EQ(smt::sat, check_result);
+
+  const smt::CheckResult max_check_result = Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      x = x + 1;
+    }
+
+    Threads::error(x == 3, encoders);
+  }, 2, encoders);
+
+  EXPECT_EQ(smt::unknown, max_check_result);
+}
+
+TEST(ThreadTest, MaxUnwindingBoundCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    int k = 0;
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      x = ++k;
+    }
+
+    Threads::error(x == 3, encoders);
+  }, 2, encoders);
+
+  EXPECT_EQ(smt::unknown, check_result);
+}
+
+TEST(ThreadTest, FullyUnwoundCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::unwinding_check([&encoders]() {
+    SharedVar<int> x;
+    x = 0;
+
+    // loop body is executed at most once
+    LocalVar<bool> b;
+    b = true;
+
+    int k = 0;
+    while (ThisThread::unwind_loop(alloc_read_instr(b),
+           make_loop_policy<__COUNTER__, 1>())) {
+      x = ++k;
+      b = false;
+    }
+
+    Threads::error(x == 2, encoders);
+  }, 5, encoders);
+
+  EXPECT_EQ(smt::unsat, check_result);
+}
+
+TEST(ThreadTest, InductionCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::induction_check([&encoders]() {
+    LocalVar<bool> a;
+    a = induction_init(false);
+
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      Threads::error(alloc_read_instr(a), encoders);
+      a = false;
+    }
+  }, 1, encoders);
+
+  EXPECT_EQ(smt::unsat, check_result);
+}
+
+// without induction_init(), the inductive step is only a bounded check
+TEST(ThreadTest, InductionCheckWithoutArbitraryState) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::induction_check([&encoders]() {
+    LocalVar<bool> a;
+    a = false;
+
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      Threads::error(alloc_read_instr(a), encoders);
+      a = false;
+    }
+  }, 1, encoders);
+
+  EXPECT_EQ(smt::unknown, check_result);
+}
+
+TEST(ThreadTest, TwoInductionCheck) {
+  Encoders encoders;
+
+  // a is false as long as b was false in the previous iteration
+  auto program = [&encoders]() {
+    LocalVar<bool> a;
+    LocalVar<bool> b;
+    a = induction_init(false);
+    b = induction_init(false);
+
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      Threads::error(alloc_read_instr(a), encoders);
+      a = b;
+      b = false;
+    }
+  };
+
+  EXPECT_EQ(smt::unknown, Threads::induction_check(program, 1, encoders));
+  EXPECT_EQ(smt::unsat, Threads::induction_check(program, 2, encoders));
+}
+
+TEST(ThreadTest, BaseCaseCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::induction_check([&encoders]() {
+    LocalVar<bool> a;
+    a = induction_init(false);
+
+    // error in the second iteration
+    while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+      Threads::error(alloc_read_instr(a), encoders);
+      a = true;
+    }
+  }, 3, encoders);
+
+  EXPECT_EQ(smt::sat, check_result);
+}
+
+TEST(ThreadTest, ChildThreadInductionCheck) {
+  Encoders encoders;
+
+  // same loop as in TwoInductionCheck but in a child thread
+  auto program = [&encoders]() {
+    Thread t([&encoders]() {
+      LocalVar<bool> a;
+      LocalVar<bool> b;
+      a = induction_init(false);
+      b = induction_init(false);
+
+      while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+        Threads::error(alloc_read_instr(a), encoders);
+        a = b;
+        b = false;
+      }
+    });
+    t.join();
+  };
+
+  EXPECT_EQ(smt::unknown, Threads::induction_check(program, 1, encoders));
+  EXPECT_EQ(smt::unsat, Threads::induction_check(program, 2, encoders));
+}
+
+TEST(ThreadTest, ChildThreadBaseCaseCheck) {
+  Encoders encoders;
+
+  const smt::CheckResult check_result = Threads::induction_check([&encoders]() {
+    Thread t([&encoders]() {
+      LocalVar<bool> a;
+      a = induction_init(false);
+
+      // error in the second iteration
+      while (ThisThread::unwind_loop(any<bool>(), make_loop_policy<__COUNTER__, 1>())) {
+        Threads::error(alloc_read_instr(a), encoders);
+        a = true;
+      }
+    });
+    t.join();
+  }, 3, encoders);
+
+  EXPECT_EQ(smt::sat, check_result);
+}
+
+static void record_nested_branches(bool is_contradictory, Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  SharedVar<int> y;
+  x = 1;
+  y = 1;
+
+  LocalVar<int> a;
+  a = x;
+
+  const std::shared_ptr<ReadInstr<bool>> condition_ptr(a < 3);
+  const std::shared_ptr<ReadInstr<bool>> inner_condition_ptr(
+    is_contradictory ? 2 < a : a < 2);
+
+  ThisThread::begin_then(condition_ptr);
+  ThisThread::begin_then(inner_condition_ptr);
+  Threads::error(y == 1, encoders);
+  ThisThread::end_branch();
+  ThisThread::end_branch();
+}
+
+TEST(ThreadTest, TwoPhaseCheck) {
+  Encoders encoders;
+
+  record_nested_branches(false, encoders);
+  EXPECT_EQ(smt::sat, Threads::two_phase_check(encoders));
+}
+
+TEST(ThreadTest, InfeasibleTwoPhaseCheck) {
+  Encoders encoders;
+
+  record_nested_branches(true, encoders);
+  EXPECT_EQ(smt::unsat, Threads::two_phase_check(encoders));
+}
@@ -0,0 +1,183 @@
+#include <cstdio>
+
+#include "concurrent.h"
+#include "concurrent/verdict_cache.h"
+#include "gtest/gtest.h"
+
+using namespace se;
+using namespace se::ops;
+
+static const char* const verdict_cache_path = "verdict_cache_test.bin";
+
+static Fingerprint make_fingerprint(size_t word) {
+  Fingerprint fingerprint;
+  fingerprint.append(word);
+  return fingerprint;
+}
+
+TEST(VerdictCacheTest, Persistence) {
+  std::remove(verdict_cache_path);
+
+  {
+    VerdictCache verdict_cache(verdict_cache_path, "r1");
+    EXPECT_EQ(0, verdict_cache.size());
+    EXPECT_EQ(smt::unknown, verdict_cache.find(make_fingerprint(7)));
+
+    verdict_cache.insert(make_fingerprint(7), smt::sat);
+    verdict_cache.insert(make_fingerprint(8), smt::unsat);
+    verdict_cache.insert(make_fingerprint(9), smt::unknown);
+
+    EXPECT_EQ(2, verdict_cache.size());
+    EXPECT_EQ(smt::sat, verdict_cache.find(make_fingerprint(7)));
+    EXPECT_EQ(smt::unsat, verdict_cache.find(make_fingerprint(8)));
+    EXPECT_EQ(smt::unknown, verdict_cache.find(make_fingerprint(9)));
+  }
+
+  const VerdictCache verdict_cache(verdict_cache_path, "r1");
+  EXPECT_EQ(2, verdict_cache.size());
+  EXPECT_EQ(smt::sat, verdict_cache.find(make_fingerprint(7)));
+  EXPECT_EQ(smt::unsat, verdict_cache.find(make_fingerprint(8)));
+
+  std::remove(verdict_cache_path);
+}
+
+TEST(VerdictCacheTest, SaltMismatch) {
+  std::remove(verdict_cache_path);
+
+  {
+    VerdictCache verdict_cache(verdict_cache_path, "r1");
+    verdict_cache.insert(make_fingerprint(7), smt::unsat);
+  }
+
+  {
+    const VerdictCache verdict_cache(verdict_cache_path, "r1");
+    EXPECT_EQ(1, verdict_cache.size());
+    EXPECT_EQ(smt::unsat, verdict_cache.find(make_fingerprint(7)));
+  }
+
+  {
+    // records of another salt are discarded
+    const VerdictCache verdict_cache(verdict_cache_path, "r2");
+    EXPECT_EQ(0, verdict_cache.size());
+    EXPECT_EQ(smt::unknown, verdict_cache.find(make_fingerprint(7)));
+  }
+
+  const VerdictCache verdict_cache(verdict_cache_path, "r1");
+  EXPECT_EQ(0, verdict_cache.size());
+
+  std::remove(verdict_cache_path);
+}
+
+TEST(VerdictCacheTest, FullFingerprint) {
+  VerdictCache verdict_cache;
+
+  Fingerprint fingerprint;
+  fingerprint.append(7);
+  fingerprint.append(8);
+  verdict_cache.insert(fingerprint, smt::unsat);
+
+  // a prefix of the fingerprint is a different program
+  EXPECT_EQ(smt::unknown, verdict_cache.find(make_fingerprint(7)));
+  EXPECT_EQ(0, verdict_cache.hit_count());
+  EXPECT_EQ(smt::unsat, verdict_cache.find(fingerprint));
+  EXPECT_EQ(1, verdict_cache.hit_count());
+
+  verdict_cache.insert(make_fingerprint(7), smt::sat);
+  EXPECT_EQ(2, verdict_cache.size());
+  EXPECT_EQ(smt::sat, verdict_cache.find(make_fingerprint(7)));
+  EXPECT_EQ(smt::unsat, verdict_cache.find(fingerprint));
+}
+
+static void record_program(int error_value, Encoders& encoders) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<int> x;
+  x = 1;
+
+  Threads::begin_thread();
+  x = 2;
+  Threads::end_thread();
+
+  Threads::error(x == error_value, encoders);
+}
+
+TEST(VerdictCacheTest, ProgramFingerprint) {
+  Encoders encoders;
+
+  record_program(2, encoders);
+  const std::vector<size_t> words(Threads::program_fingerprint().words());
+  Threads::end_main_thread(encoders);
+
+  record_program(2, encoders);
+  EXPECT_EQ(words, Threads::program_fingerprint().words());
+  Threads::end_main_thread(encoders);
+
+  record_program(3, encoders);
+  EXPECT_NE(words, Threads::program_fingerprint().words());
+  Threads::end_main_thread(encoders);
+}
+
+TEST(VerdictCacheTest, InternalErrorFingerprint) {
+  Encoders encoders;
+
+  record_program(2, encoders);
+  const std::vector<size_t> words(Threads::program_fingerprint().words());
+  Threads::end_main_thread(encoders);
+
+  // the same program with an additional assertion
+  record_program(2, encoders);
+  Threads::internal_error(any<bool>(), encoders);
+  EXPECT_NE(words, Threads::program_fingerprint().words());
+  Threads::end_main_thread(encoders);
+}
+
+// \returns fingerprint of an unlock event that releases the first or
+//   second of two locks of the same mutex
+static std::vector<size_t> unlock_fingerprint_words(bool is_first) {
+  Event::reset_id();
+  Zone::reset();
+
+  const Zone zone = Zone::unique_atom();
+  const std::shared_ptr<LockEvent> first_lock_event_ptr(new LockEvent(7, zone));
+  const std::shared_ptr<LockEvent> second_lock_event_ptr(new LockEvent(7, zone));
+  const UnlockEvent unlock_event(7,
+    is_first ? first_lock_event_ptr : second_lock_event_ptr);
+
+  Fingerprint fingerprint;
+  unlock_event.fingerprint(fingerprint);
+  return fingerprint.words();
+}
+
+TEST(VerdictCacheTest, UnlockEventFingerprint) {
+  // the critical sections start at different lock events
+  EXPECT_NE(unlock_fingerprint_words(true), unlock_fingerprint_words(false));
+}
+
+TEST(VerdictCacheTest, CachedCheck) {
+  std::remove(verdict_cache_path);
+  VerdictCache verdict_cache(verdict_cache_path, "r1");
+
+  {
+    Encoders encoders;
+    record_program(2, encoders);
+    EXPECT_EQ(smt::sat, Threads::cached_check(verdict_cache, encoders));
+    EXPECT_EQ(1, verdict_cache.size());
+  }
+
+  {
+    Encoders encoders;
+    record_program(3, encoders);
+    EXPECT_EQ(smt::unsat, Threads::cached_check(verdict_cache, encoders));
+    EXPECT_EQ(2, verdict_cache.size());
+  }
+
+  // the cached verdict is returned without encoding anything
+  Encoders encoders;
+  record_program(2, encoders);
+  EXPECT_EQ(smt::sat, Threads::cached_check(verdict_cache, encoders));
+  EXPECT_EQ(smt::sat, encoders.solver.check());
+  EXPECT_EQ(2, verdict_cache.size());
+
+  std::remove(verdict_cache_path);
+}
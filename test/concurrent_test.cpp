@@ -512,12 +512,15 @@ TEST(ConcurrencyTest, OverwriteSharedVarArrayElementWithVar) {
   EXPECT_EQ(WRITE_EVENT_ID(13), array_var.direct_write_event_ref().event_id());
 
   const BasicReadInstr<char[5]>& array_read_instr = static_cast<const BasicReadInstr<char[5]>&>(array_var.indirect_write_event_ref().deref_instr_ref().memory_ref());
-  EXPECT_EQ(READ_EVENT_ID(14), array_read_instr.event_ptr()->event_id());
+  EXPECT_EQ(READ_EVENT_ID(15), array_read_instr.event_ptr()->event_id());
+  EXPECT_EQ(array_var[2].zone(), array_read_instr.event_ptr()->zone());
 
   EXPECT_EQ(WRITE_EVENT_ID(16), array_var.indirect_write_event_ref().event_id());
+  EXPECT_EQ(array_var[2].zone(), array_var.indirect_write_event_ref().zone());
+  EXPECT_NE(array_var.zone(), array_var.indirect_write_event_ref().zone());
 
   const BasicReadInstr<char>& read_instr = dynamic_cast<const BasicReadInstr<char>&>(array_var.indirect_write_event_ref().instr_ref());
-  EXPECT_EQ(READ_EVENT_ID(15), read_instr.event_ptr()->event_id());
+  EXPECT_EQ(READ_EVENT_ID(14), read_instr.event_ptr()->event_id());
 }
 
 TEST(ConcurrencyTest, LocalArrayOffsetZone) {
@@ -535,9 +538,11 @@ TEST(ConcurrencyTest, SharedArrayOffsetZone) {
   Threads::begin_main_thread();
 
   SharedVar<long[3]> a;
-  EXPECT_EQ(a[0].zone(), a.zone());
-  EXPECT_EQ(a[1].zone(), a.zone());
-  EXPECT_EQ(a[2].zone(), a.zone());
+  SharedVar<size_t> index;
+  EXPECT_NE(a[0].zone(), a.zone());
+  EXPECT_NE(a[1].zone(), a.zone());
+  EXPECT_NE(a[2].zone(), a.zone());
+  EXPECT_EQ(a[index].zone(), a.zone());
 }
 
 TEST(ConcurrencyTest, SharedArrayZone) {
@@ -550,6 +555,178 @@ TEST(ConcurrencyTest, SharedArrayZone) {
   EXPECT_FALSE(a[1].zone().meet(a.zone()).is_bottom());
   EXPECT_FALSE(a[2].zone().meet(a.zone()).is_bottom());
 
-  EXPECT_FALSE(a[0].zone().meet(a[1].zone()).is_bottom());
-  EXPECT_FALSE(a[1].zone().meet(a[2].zone()).is_bottom());
+  EXPECT_TRUE(a[0].zone().meet(a[1].zone()).is_bottom());
+  EXPECT_TRUE(a[1].zone().meet(a[2].zone()).is_bottom());
+}
+
+TEST(ConcurrencyTest, SharedArrayElementStoreZone) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<long[3]> a;
+  SharedVar<size_t> index;
+
+  a[0] = 7L;
+  const Zone zone_0 = a.indirect_write_event_ref().zone();
+
+  a[1] = 7L;
+  const Zone zone_1 = a.indirect_write_event_ref().zone();
+
+  a[index] = 7L;
+  const Zone zone_index = a.indirect_write_event_ref().zone();
+
+  // loads through literal indexes are never related to stores of other elements
+  EXPECT_FALSE(a[0].zone().meet(zone_0).is_bottom());
+  EXPECT_TRUE(a[0].zone().meet(zone_1).is_bottom());
+  EXPECT_TRUE(a[1].zone().meet(zone_0).is_bottom());
+  EXPECT_FALSE(a[1].zone().meet(zone_index).is_bottom());
+
+  // neither are stores through literal indexes of different elements
+  EXPECT_EQ(a[0].zone(), zone_0);
+  EXPECT_EQ(a[1].zone(), zone_1);
+  EXPECT_TRUE(zone_0.meet(zone_1).is_bottom());
+  EXPECT_EQ(a.zone(), zone_index);
+}
+
+TEST(ConcurrencyTest, SharedArraySymbolicIndexReadsEachElement) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  SharedVar<long[3]> a;
+  SharedVar<size_t> index;
+
+  a[index] = 7L;
+
+  const ElementsReadInstr<long[3]>& array_read_instr = dynamic_cast<const ElementsReadInstr<long[3]>&>(a.indirect_write_event_ref().deref_instr_ref().memory_ref());
+  ASSERT_EQ(3, array_read_instr.operand_ptrs().size());
+  for (size_t k = 0; k < 3; k++) {
+    const BasicReadInstr<long[3]>& element_read_instr = dynamic_cast<const BasicReadInstr<long[3]>&>(*array_read_instr.operand_ptrs()[k]);
+    EXPECT_EQ(a[k].zone(), element_read_instr.event_ptr()->zone());
+  }
+}
+
+static void relate_shared_events(const Block& block,
+  ZoneRelation<Event>& zone_relation) {
+
+  for (const std::shared_ptr<Event>& event_ptr : block.body()) {
+    if (!event_ptr->zone().is_bottom()) {
+      zone_relation.relate(event_ptr);
+    }
+  }
+
+  for (const std::shared_ptr<Block>& inner_block_ptr : block.inner_block_ptrs()) {
+    relate_shared_events(*inner_block_ptr, zone_relation);
+  }
+}
+
+TEST(ConcurrencyTest, SharedArrayElementStoresInTwoThreads) {
+  Threads::reset();
+  Threads::begin_main_thread();
+  const ThreadId main_thread_id = ThisThread::thread_id();
+
+  SharedVar<long[3]> a;
+
+  Threads::begin_thread();
+  const ThreadId thread_id_0 = ThisThread::thread_id();
+  a[0] = 7L;
+  Threads::end_thread();
+
+  Threads::begin_thread();
+  const ThreadId thread_id_1 = ThisThread::thread_id();
+  a[1] = 8L;
+  Threads::end_thread();
+
+  ZoneRelation<Event> zone_relation;
+  for (ThreadId thread_id : {main_thread_id, thread_id_0, thread_id_1}) {
+    relate_shared_events(*Threads::slice_most_outer_block_ptr(thread_id),
+      zone_relation);
+  }
+
+  // the store of each thread is only related to the array's initialization
+  unsigned count = 0;
+  for (const std::shared_ptr<Event>& event_ptr : zone_relation.event_ptrs()) {
+    if (event_ptr->thread_id() != thread_id_0) {
+      continue;
+    }
+
+    count++;
+    for (const std::shared_ptr<Event>& other_event_ptr :
+         zone_relation.find(event_ptr->zone(), AnyEventPredicate::predicate())) {
+      EXPECT_NE(thread_id_1, other_event_ptr->thread_id());
+    }
+  }
+
+  // one read and one write of the array
+  EXPECT_EQ(2, count);
+}
+
+TEST(ConcurrencyTest, BinaryOperatorFoldsLiterals) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  std::unique_ptr<ReadInstr<bool>> instr_ptr(alloc_read_instr(3L) < 'Z');
+
+  const LiteralReadInstr<bool>& instr = dynamic_cast<const LiteralReadInstr<bool>&>(*instr_ptr);
+  EXPECT_TRUE(instr.literal());
+
+  std::unique_ptr<ReadInstr<bool>> not_instr_ptr(! std::move(instr_ptr));
+
+  const LiteralReadInstr<bool>& not_instr = dynamic_cast<const LiteralReadInstr<bool>&>(*not_instr_ptr);
+  EXPECT_FALSE(not_instr.literal());
+}
+
+TEST(ConcurrencyTest, BinaryOperatorFoldsLiteralsWithBothConditions) {
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  std::unique_ptr<ReadInstr<long>> unconditional_instr_ptr(alloc_read_instr(3L));
+
+  ThisThread::begin_then(any<bool>());
+  const std::shared_ptr<ReadInstr<bool>> outer_condition_ptr(
+    ThisThread::path_condition_ptr());
+
+  // the unconditional operand does not add a condition
+  std::unique_ptr<ReadInstr<bool>> instr_ptr(
+    std::move(unconditional_instr_ptr) < alloc_read_instr(4L));
+  EXPECT_EQ(outer_condition_ptr, instr_ptr->condition_ptr());
+
+  std::unique_ptr<ReadInstr<long>> outer_instr_ptr(alloc_read_instr(3L));
+
+  ThisThread::begin_then(any<bool>());
+  const std::shared_ptr<ReadInstr<bool>> inner_condition_ptr(
+    ThisThread::path_condition_ptr());
+
+  std::unique_ptr<ReadInstr<bool>> nested_instr_ptr(
+    std::move(outer_instr_ptr) < alloc_read_instr(4L));
+  EXPECT_TRUE(dynamic_cast<const LiteralReadInstr<bool>&>(*nested_instr_ptr).literal());
+
+  const NaryReadInstr<LAND, bool>& condition =
+    dynamic_cast<const NaryReadInstr<LAND, bool>&>(*nested_instr_ptr->condition_ptr());
+  EXPECT_NE(inner_condition_ptr, nested_instr_ptr->condition_ptr());
+  EXPECT_EQ(2, condition.size());
+
+  ThisThread::end_branch();
+  ThisThread::end_branch();
+}
+
+TEST(ConcurrencyTest, SlicerWithFoldedLiteralCondition) {
+  Slicer slicer;
+
+  constexpr Location loc = __COUNTER__;
+
+  Threads::reset();
+  Threads::begin_main_thread();
+
+  for (unsigned k = 0; k < 3; k++) {
+    if (slicer.begin_then_branch(loc, alloc_read_instr(k) < 2U)) {
+      EXPECT_TRUE(k < 2U);
+    }
+    if (slicer.begin_else_branch(loc + 1)) {
+      EXPECT_FALSE(k < 2U);
+    }
+    slicer.end_branch(loc + 2);
+  }
+
+  EXPECT_EQ(nullptr, ThisThread::path_condition_ptr());
+  EXPECT_FALSE(slicer.next_slice());
 }